@@ -0,0 +1,843 @@
+// 基于伪终端模拟器的DynPick吞吐量及延迟测试，仅Linux
+// 用法：ForceSensorBench [采样数] [应答延时us] [错误注入概率]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "Aggregator.hpp"
+#include "DynPick.hpp"
+#include "DynPickSimulator.hpp"
+#include "Filter.hpp"
+#include "Recorder.hpp"
+#include "SensitivityCache.hpp"
+#include "SensorReactor.hpp"
+#include "SharedMemory.hpp"
+#include "TextWriter.hpp"
+#include "Transport.hpp"
+#include "WrenchTransform.hpp"
+
+using BenchClock = std::chrono::steady_clock;
+
+// 返回第p百分位的延迟，单位微秒
+static double Percentile(std::vector<double>& latencies, double p) {
+	if (latencies.empty()) {
+		return 0.0;
+	}
+	size_t Index = (size_t)(p / 100.0 * (double)(latencies.size() - 1) + 0.5);
+	std::nth_element(latencies.begin(), latencies.begin() + Index, latencies.end());
+	return latencies[Index];
+}
+
+static void Report(const char* name, size_t count, size_t fail, double seconds, std::vector<double>& latencies) {
+	std::cout << name << ": " << count << " samples, " << fail << " failed, "
+		<< (double)count / seconds << " samples/s";
+	if (!latencies.empty()) {
+		std::cout << ", latency p50 " << Percentile(latencies, 50.0)
+			<< " us, p99 " << Percentile(latencies, 99.0)
+			<< " us, p99.9 " << Percentile(latencies, 99.9) << " us";
+	}
+	std::cout << '\n';
+}
+
+// 传感器内部统计的各环节延迟
+static void ReportStats(const sia::ForceSensorStats& stats) {
+#if SIA_STATS
+	static const char* TIMER_NAMES[sia::TIMER_COUNT] = { "send", "reply wait", "read", "parse", "flush", "sample" };
+	for (int t = 0; t < sia::TIMER_COUNT; t++) {
+		const sia::LatencySnapshot& Latency = stats.Latency[t];
+		if (Latency.Count == 0) {
+			continue;
+		}
+		std::cout << "  " << TIMER_NAMES[t] << ": " << Latency.Count << " times, mean " << Latency.MeanNs() / 1000.0
+			<< " us, p50 " << Latency.PercentileNs(50.0) / 1000.0
+			<< " us, p99 " << Latency.PercentileNs(99.0) / 1000.0
+			<< " us, max " << Latency.MaxNs() / 1000.0 << " us\n";
+	}
+	const sia::ForceSensorStatCounters& Counters = stats.Counters;
+	std::cout << "  retries " << Counters.Retries << ", rejects " << Counters.FrameRejects
+		<< ", timeouts " << Counters.Timeouts << ", short reads " << Counters.ShortReads
+		<< ", flushed " << Counters.FlushedBytes << " bytes, discarded " << Counters.DiscardedBytes << " bytes\n";
+#else
+	(void)stats;
+#endif // SIA_STATS
+}
+
+// 请求应答模式：每个采样发送一次"R"，统计请求到得到数据的延迟
+static void BenchRequestResponse(sia::DynPick& sensor, size_t count) {
+	sensor.ResetStats();
+	std::vector<double> Latencies;
+	Latencies.reserve(count);
+	size_t Fail = 0;
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		auto T0 = BenchClock::now();
+		if (!sensor.UpdateDataUntilCorrect()) {
+			Fail++;
+			continue;
+		}
+		auto T1 = BenchClock::now();
+		Latencies.push_back(std::chrono::duration<double, std::micro>(T1 - T0).count());
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	Report("request/response", Latencies.size(), Fail, Seconds, Latencies);
+	ReportStats(sensor.GetStats());
+}
+
+// 编译期绑定协议的传感器：与上面的虚函数版本对比请求应答的开销
+static void BenchBasicSensor(const std::string& portName, size_t count) {
+	sia::DynPickSensor Sensor(sia::SerialConfig{ portName, 921600u, 8, 1, 'N' });
+	if (!Sensor.Open() || !Sensor.Init()) {
+		std::cout << "basic sensor: open/init failed\n";
+		return;
+	}
+	std::vector<double> Latencies;
+	Latencies.reserve(count);
+	sia::ForceSensorSample Sample;
+	size_t Fail = 0;
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		auto T0 = BenchClock::now();
+		if (!Sensor.UpdateUntilCorrect(&Sample)) {
+			Fail++;
+			continue;
+		}
+		auto T1 = BenchClock::now();
+		Latencies.push_back(std::chrono::duration<double, std::micro>(T1 - T0).count());
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	Report("request/response (basic)", Latencies.size(), Fail, Seconds, Latencies);
+}
+
+// 连续输出模式：统计得到的采样数，以及从收到数据帧到被取出的延迟
+static void BenchStream(sia::DynPick& sensor, size_t count) {
+	std::vector<double> Latencies;
+	Latencies.reserve(count);
+	sia::ForceSensorSample Sample;
+	size_t Received = 0;
+	if (!sensor.StartStream()) {
+		std::cout << "stream: start failed\n";
+		return;
+	}
+	auto Start = BenchClock::now();
+	auto Deadline = Start + std::chrono::seconds(10);
+	while (Received < count && BenchClock::now() < Deadline) {
+		if (sensor.ReadNextSample(&Sample)) {
+			Latencies.push_back((double)(sia::MonotonicNs() - Sample.ReceiveTimeNs) / 1000.0);
+			Received++;
+		}
+		else {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	sensor.StopStream();
+	Report("stream", Received, count - Received, Seconds, Latencies);
+}
+
+// 订阅：采集线程对每个采样调用回调，统计从收到数据帧到回调的延迟。先尝试实时配置，权限不足时退回普通线程
+static void BenchSubscribe(sia::DynPick& sensor, size_t count, bool stream, uint32_t inFlight = 1) {
+	std::vector<double> Latencies(count);
+	std::atomic<size_t> Received{ 0 };
+	auto Callback = [&Latencies, &Received, count](const sia::ForceSensorSample& sample) {
+		const size_t Index = Received.load(std::memory_order_relaxed);
+		if (Index < count) {
+			Latencies[Index] = (double)(sia::MonotonicNs() - sample.ReceiveTimeNs) / 1000.0;
+			Received.store(Index + 1, std::memory_order_release);
+		}
+	};
+	sia::SubscribeOptions Options;
+	Options.Stream = stream;
+	Options.InFlight = inFlight;
+	Options.RealTime.Cpu = 1;
+	Options.RealTime.Priority = 80;
+	Options.RealTime.LockMemory = true;
+	std::string Name = stream ? "subscribe stream" : "subscribe polling x" + std::to_string(inFlight);
+	auto Start = BenchClock::now();
+	if (sensor.Subscribe(Callback, Options)) {
+		Name += " (rt)";
+	}
+	else {
+		Options.RealTime = sia::RealTimeConfig();
+		Start = BenchClock::now();
+		if (!sensor.Subscribe(Callback, Options)) {
+			std::cout << Name << ": subscribe failed\n";
+			return;
+		}
+	}
+	auto Deadline = Start + std::chrono::seconds(10);
+	while (Received.load(std::memory_order_acquire) < count && BenchClock::now() < Deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	sensor.Unsubscribe();
+	Latencies.resize(Received.load(std::memory_order_acquire));
+	Report(Name.c_str(), Latencies.size(), count - Latencies.size(), Seconds, Latencies);
+}
+
+// 按周期订阅：请求应答模式下以绝对时刻每period发送一次请求，统计相邻请求间隔与周期之差
+static void BenchRate(sia::DynPick& sensor, size_t count, std::chrono::microseconds period, std::chrono::microseconds spin) {
+	std::vector<int64_t> RequestTimes(count);
+	std::atomic<size_t> Received{ 0 };
+	auto Callback = [&RequestTimes, &Received, count](const sia::ForceSensorSample& sample) {
+		const size_t Index = Received.load(std::memory_order_relaxed);
+		if (Index < count) {
+			RequestTimes[Index] = sample.RequestTimeNs;
+			Received.store(Index + 1, std::memory_order_release);
+		}
+	};
+	sia::SubscribeOptions Options;
+	Options.Stream = false;
+	Options.Period = period;
+	Options.Spin = spin;
+	auto Start = BenchClock::now();
+	if (!sensor.Subscribe(Callback, Options)) {
+		std::cout << "rate: subscribe failed\n";
+		return;
+	}
+	auto Deadline = Start + period * count + std::chrono::seconds(5);
+	while (Received.load(std::memory_order_acquire) < count && BenchClock::now() < Deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	sensor.Unsubscribe();
+	const size_t Count = Received.load(std::memory_order_acquire);
+	std::vector<double> Errors; // 请求间隔与周期之差的绝对值，微秒
+	for (size_t i = 1; i < Count; i++) {
+		const int64_t ErrorNs = RequestTimes[i] - RequestTimes[i - 1] - std::chrono::duration_cast<std::chrono::nanoseconds>(period).count();
+		Errors.push_back((double)(ErrorNs < 0 ? -ErrorNs : ErrorNs) / 1000.0);
+	}
+	const std::string Name = "rate " + std::to_string(period.count()) + " us, spin " + std::to_string(spin.count()) + " us (jitter)";
+	Report(Name.c_str(), Count, count - Count, Seconds, Errors);
+	sia::RateSchedulerStats Stats = sensor.GetRateStats();
+	std::cout << "  cycles " << Stats.Cycles << ", overruns " << Stats.Overruns << ", skipped " << Stats.SkippedCycles
+		<< ", max lateness " << (double)Stats.MaxLatenessNs / 1000.0 << " us\n";
+}
+
+// 广播：一个生产者尽快写入，三个消费者按不同频率读取（每个都读、每10个读一个、每毫秒读一次），统计写入速度及各自的丢失
+static void BenchBroadcast(size_t count) {
+	std::unique_ptr<sia::ForceSensorBroadcast> pRing = std::make_unique<sia::ForceSensorBroadcast>();
+	std::atomic<bool> Done{ false };
+	struct ReaderResult {
+		uint64_t Received;
+		uint64_t Lost;
+		uint64_t Disorder; // 序号不递增的次数，应为0
+	};
+	ReaderResult Results[3] = {};
+	auto ReaderLoop = [&pRing, &Done](uint32_t decimation, std::chrono::microseconds interval, ReaderResult* pResult) {
+		sia::ForceSensorReader Reader(*pRing, decimation);
+		sia::ForceSensorSample Sample;
+		uint64_t LastSequence = 0;
+		while (true) {
+			const bool Finished = Done.load(std::memory_order_acquire);
+			while (Reader.Next(&Sample)) {
+				pResult->Received++;
+				if (Sample.Sequence <= LastSequence) {
+					pResult->Disorder++;
+				}
+				LastSequence = Sample.Sequence;
+			}
+			if (Finished) {
+				break;
+			}
+			if (interval.count() > 0) {
+				std::this_thread::sleep_for(interval);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+		pResult->Lost = Reader.LostCount();
+	};
+	std::thread Readers[3] = {
+		std::thread(ReaderLoop, 1, std::chrono::microseconds(0), &Results[0]),
+		std::thread(ReaderLoop, 10, std::chrono::microseconds(0), &Results[1]),
+		std::thread(ReaderLoop, 1, std::chrono::microseconds(1000), &Results[2]),
+	};
+	sia::ForceSensorSample Sample = { {}, 0, 0, 0, sia::SAMPLE_VALID };
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		Sample.Sequence = i + 1;
+		Sample.Data[0] = (float)i;
+		pRing->Publish(Sample);
+		if ((i & 1023) == 0) {
+			std::this_thread::yield(); // 单核时给消费者运行的机会
+		}
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	Done.store(true, std::memory_order_release);
+	for (auto& Reader : Readers) {
+		Reader.join();
+	}
+	std::cout << "broadcast: " << count << " published, " << (double)count / Seconds << " samples/s\n";
+	const char* Names[3] = { "every sample", "decimate 10", "every 1 ms" };
+	for (int i = 0; i < 3; i++) {
+		std::cout << "  " << Names[i] << ": received " << Results[i].Received << ", lost " << Results[i].Lost
+			<< ", disorder " << Results[i].Disorder << '\n';
+	}
+}
+
+// 共享内存：发布者按固定间隔发布，客户端线程阻塞等待（futex），统计从发布到客户端读到的延迟
+static void BenchSharedMemory(size_t count) {
+	const char* NAME = "/sia_force_sensor_bench";
+	sia::ForceSensorShmPublisher Publisher;
+	if (!Publisher.Open(NAME)) {
+		std::cout << "shared memory: open failed\n";
+		return;
+	}
+	sia::ForceSensorShmClient Client;
+	if (!Client.Open(NAME)) {
+		std::cout << "shared memory: attach failed\n";
+		return;
+	}
+	std::vector<double> Latencies;
+	Latencies.reserve(count);
+	uint64_t Disorder = 0;
+	std::thread Reader([&Client, &Latencies, &Disorder, count]() {
+		sia::ForceSensorSample Sample;
+		uint64_t LastSequence = 0;
+		while (Latencies.size() < count && Client.WaitNext(&Sample, std::chrono::seconds(1))) {
+			Latencies.push_back((double)(sia::MonotonicNs() - Sample.ReceiveTimeNs) / 1000.0);
+			if (Sample.Sequence <= LastSequence) {
+				Disorder++;
+			}
+			LastSequence = Sample.Sequence;
+		}
+	});
+	sia::ForceSensorSample Sample = { {}, 0, 0, 0, sia::SAMPLE_VALID };
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		Sample.Sequence = i + 1;
+		Sample.ReceiveTimeNs = sia::MonotonicNs();
+		Publisher.Publish(Sample);
+		std::this_thread::sleep_for(std::chrono::microseconds(100)); // 客户端每次都需要被唤醒
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	Reader.join();
+	Publisher.Close();
+	Report("shared memory (futex wake)", Latencies.size(), count - Latencies.size(), Seconds, Latencies);
+	std::cout << "  lost " << Client.LostCount() << ", disorder " << Disorder << '\n';
+}
+
+// 连续输出模式批量读取：每次最多取出64个采样，缓存为空时阻塞等待
+static void BenchStreamBatch(sia::DynPick& sensor, size_t count) {
+	constexpr size_t BATCH_SIZE = 64;
+	std::vector<double> Latencies;
+	Latencies.reserve(count);
+	sia::ForceSensorSample Samples[BATCH_SIZE];
+	size_t Received = 0;
+	size_t Calls = 0;
+	if (!sensor.StartStream()) {
+		std::cout << "stream batch: start failed\n";
+		return;
+	}
+	auto Start = BenchClock::now();
+	auto Deadline = Start + std::chrono::seconds(10);
+	while (Received < count && BenchClock::now() < Deadline) {
+		size_t Count = sensor.ReadSamples(Samples, BATCH_SIZE, BenchClock::now() + std::chrono::milliseconds(100));
+		const int64_t NowNs = sia::MonotonicNs();
+		for (size_t i = 0; i < Count; i++) {
+			Latencies.push_back((double)(NowNs - Samples[i].ReceiveTimeNs) / 1000.0);
+		}
+		Received += Count;
+		Calls++;
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	sensor.StopStream();
+	Report("stream batch", Received, (Received < count) ? count - Received : 0, Seconds, Latencies);
+	std::cout << "stream batch: " << (double)Received / (double)(Calls > 0 ? Calls : 1) << " samples/call\n";
+}
+
+// 多传感器：依次请求与SensorReactor同时请求的每轮耗时对比
+static void BenchReactor(const sia::DynPickSimulatorConfig& simCfg, size_t count) {
+	constexpr size_t SENSOR_COUNT = 4;
+	std::vector<std::unique_ptr<sia::DynPickSimulator>> Sims;
+	std::vector<std::unique_ptr<sia::DynPick>> Sensors;
+	sia::SensorReactor Reactor;
+	for (size_t i = 0; i < SENSOR_COUNT; i++) {
+		Sims.push_back(std::make_unique<sia::DynPickSimulator>(simCfg));
+		if (!Sims.back()->Start()) {
+			std::cout << "reactor: simulator start failed\n";
+			return;
+		}
+		Sensors.push_back(std::make_unique<sia::DynPick>(sia::SerialConfig{ Sims.back()->SlaveName(), 921600u, 8, 1, 'N' }));
+		if (!Sensors.back()->Open() || !Sensors.back()->Init() || Reactor.Add(Sensors.back().get()) < 0) {
+			std::cout << "reactor: sensor init failed\n";
+			return;
+		}
+	}
+
+	std::vector<double> Latencies;
+	Latencies.reserve(count);
+	size_t Fail = 0;
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		auto T0 = BenchClock::now();
+		for (auto& Sensor : Sensors) {
+			if (!Sensor->UpdateDataUntilCorrect()) {
+				Fail++;
+			}
+		}
+		Latencies.push_back(std::chrono::duration<double, std::micro>(BenchClock::now() - T0).count());
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	Report("4 sensors sequential (cycles)", count, Fail, Seconds, Latencies);
+
+	Latencies.clear();
+	Fail = 0;
+	Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		auto T0 = BenchClock::now();
+		Fail += SENSOR_COUNT - Reactor.PollOnce(std::chrono::milliseconds(sia::REPLY_TIMEOUT_MS));
+		Latencies.push_back(std::chrono::duration<double, std::micro>(BenchClock::now() - T0).count());
+	}
+	Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	Report("4 sensors reactor (cycles)", count, Fail, Seconds, Latencies);
+}
+
+// 多传感器启动：依次Init、InitAll同时Init及命中灵敏度缓存时的耗时，以及之后得到第一个采样的耗时
+static void BenchInit(uint32_t replyDelayUs) {
+	constexpr size_t SENSOR_COUNT = 4;
+	sia::DynPickSimulatorConfig SimCfg;
+	SimCfg.ReplyDelayUs = replyDelayUs;
+	SimCfg.StreamPeriodUs = 0;
+	std::vector<std::unique_ptr<sia::DynPickSimulator>> Sims;
+	for (size_t i = 0; i < SENSOR_COUNT; i++) {
+		Sims.push_back(std::make_unique<sia::DynPickSimulator>(SimCfg));
+		if (!Sims.back()->Start()) {
+			std::cout << "init: simulator start failed\n";
+			return;
+		}
+	}
+	sia::SensitivityCache Cache; // 只在内存中缓存
+	auto Run = [&Sims, &Cache](const char* name, bool parallel, bool useCache) {
+		std::vector<std::unique_ptr<sia::DynPick>> Sensors;
+		std::vector<sia::ForceSensor*> Pointers;
+		for (auto& Sim : Sims) {
+			Sensors.push_back(std::make_unique<sia::DynPick>(sia::SerialConfig{ Sim->SlaveName(), 921600u, 8, 1, 'N' }));
+			if (useCache) {
+				Sensors.back()->SetLsbCache(&Cache, Sim->SlaveName());
+			}
+			if (!Sensors.back()->Open()) {
+				std::cout << "init: open failed\n";
+				return;
+			}
+			Pointers.push_back(Sensors.back().get());
+		}
+		auto Start = BenchClock::now();
+		size_t SuccessCount = 0;
+		if (parallel) {
+			SuccessCount = sia::InitAll(Pointers);
+		}
+		else {
+			for (auto& Sensor : Sensors) {
+				SuccessCount += Sensor->Init() ? 1 : 0;
+			}
+		}
+		const double InitMs = std::chrono::duration<double, std::milli>(BenchClock::now() - Start).count();
+		for (auto& Sensor : Sensors) {
+			Sensor->UpdateDataUntilCorrect();
+		}
+		const double FirstSampleMs = std::chrono::duration<double, std::milli>(BenchClock::now() - Start).count();
+		size_t Verified = 0;
+		for (auto& Sensor : Sensors) {
+			Verified += (Sensor->GetLsbState() == sia::LSB_CACHE_VERIFIED) ? 1 : 0;
+		}
+		std::cout << name << ": " << SuccessCount << '/' << Sensors.size() << " ok, init " << InitMs
+			<< " ms, first samples " << FirstSampleMs << " ms";
+		if (useCache) {
+			std::cout << ", cache verified " << Verified;
+		}
+		std::cout << '\n';
+	};
+	Run("init sequential", false, false);
+	Run("init parallel (InitAll)", true, false);
+	Run("init parallel, cache miss", true, true);
+	Run("init parallel, cache hit", true, true);
+}
+
+// 多传感器对齐：3个以1kHz连续输出的传感器，每1ms对齐一次，统计Tick耗时及各来源的次数
+static void BenchAggregator(size_t ticks) {
+	constexpr size_t SENSOR_COUNT = 3;
+	sia::DynPickSimulatorConfig SimCfg;
+	SimCfg.StreamPeriodUs = 1000;
+	std::vector<std::unique_ptr<sia::DynPickSimulator>> Sims;
+	std::vector<std::unique_ptr<sia::DynPick>> Sensors;
+	sia::ForceSensorAggregator Aggregator(5000000, 2000000); // 最大时差5ms，对齐到2ms之前
+	for (size_t i = 0; i < SENSOR_COUNT; i++) {
+		Sims.push_back(std::make_unique<sia::DynPickSimulator>(SimCfg));
+		if (!Sims.back()->Start()) {
+			std::cout << "aggregator: simulator start failed\n";
+			return;
+		}
+		Sensors.push_back(std::make_unique<sia::DynPick>(sia::SerialConfig{ Sims.back()->SlaveName(), 921600u, 8, 1, 'N' }));
+		if (!Sensors.back()->Open() || !Sensors.back()->Init() || Aggregator.Add(*Sensors.back()) < 0 || !Sensors.back()->StartStream()) {
+			std::cout << "aggregator: sensor init failed\n";
+			return;
+		}
+	}
+	size_t StatusCounts[sia::AGGREGATE_NO_DATA + 1] = {};
+	std::vector<double> Latencies;
+	Latencies.reserve(ticks);
+	sia::RateScheduler Rate(std::chrono::milliseconds(1));
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < ticks; i++) {
+		Rate.Wait();
+		auto T0 = BenchClock::now();
+		const sia::AggregatedFrame& Frame = Aggregator.Tick();
+		Latencies.push_back(std::chrono::duration<double, std::micro>(BenchClock::now() - T0).count());
+		for (size_t j = 0; j < Frame.SensorCount; j++) {
+			StatusCounts[Frame.Status[j]]++;
+		}
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	for (auto& Sensor : Sensors) {
+		Sensor->StopStream();
+	}
+	Report("aggregator 3 sensors (ticks, Tick latency)", ticks, 0, Seconds, Latencies);
+	std::cout << "aggregator: interpolated " << StatusCounts[sia::AGGREGATE_INTERPOLATED] << ", held " << StatusCounts[sia::AGGREGATE_HELD]
+		<< ", earliest " << StatusCounts[sia::AGGREGATE_EARLIEST] << ", stale " << StatusCounts[sia::AGGREGATE_STALE]
+		<< ", no data " << StatusCounts[sia::AGGREGATE_NO_DATA] << '\n';
+}
+
+// 内存回环：应答函数同步返回固定的数据帧，不经过内核，测试请求应答路径本身的开销
+static void BenchLoopback(size_t count) {
+	static const char DATA_FRAME[] = "0800080008000800080008000\r\n";
+	auto pTransport = std::make_unique<sia::LoopbackTransport>([](const char* data, int size, sia::LoopbackTransport& transport) {
+		for (int i = 0; i < size; i++) {
+			if (data[i] == 'R') {
+				transport.Inject(DATA_FRAME, sizeof(DATA_FRAME) - 1);
+			}
+			else if (data[i] == 'p') {
+				transport.Inject(sia::DynPickSimulator::LSB_LINE, strlen(sia::DynPickSimulator::LSB_LINE));
+			}
+		}
+	});
+	sia::DynPick Sensor(std::move(pTransport));
+	if (!Sensor.Open() || !Sensor.Init()) {
+		std::cout << "loopback: open/init failed\n";
+		return;
+	}
+	size_t Fail = 0;
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		if (!Sensor.UpdateDataUntilCorrect()) {
+			Fail++;
+		}
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	std::vector<double> NoLatencies;
+	Report("loopback request/response", count - Fail, Fail, Seconds, NoLatencies);
+}
+
+// 回放：尽快回放录制的连续输出字节流，测试重组、解析及环形缓冲区的吞吐量
+static void BenchReplay(size_t count) {
+	auto pTransport = std::make_unique<sia::ReplayTransport>(false);
+	char Frame[32];
+	for (size_t i = 0; i < count; i++) {
+		snprintf(Frame, sizeof(Frame), "%u%04X%04X%04X%04X%04X%04X\r\n", (unsigned)(i % 10),
+			(unsigned)(i & 0xFFFF), 0x8000u, 0x8000u, 0x8000u, 0x8000u, (unsigned)((i * 3) & 0xFFFF));
+		pTransport->Append(0, Frame, 27);
+	}
+	sia::DynPick Sensor(std::move(pTransport));
+	if (!Sensor.Open() || !Sensor.StartStream()) {
+		std::cout << "replay: open/start failed\n";
+		return;
+	}
+	float Checksum = 0.0f;
+	size_t Received = 0;
+	auto Start = BenchClock::now();
+	auto Deadline = Start + std::chrono::seconds(10);
+	while (Sensor.GetCounters().SampleCount < count && BenchClock::now() < Deadline) {
+		sia::ForceSensorSampleSpan Span = Sensor.PeekSamples(BenchClock::now() + std::chrono::milliseconds(10));
+		for (const sia::ForceSensorSample& Item : Span) {
+			Checksum += Item.Data[0];
+		}
+		Received += Span.Size;
+		Sensor.ReleaseSamples(Span.Size);
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	Sensor.StopStream();
+	std::vector<double> NoLatencies;
+	Report("replay stream (parsed)", (size_t)Sensor.GetCounters().SampleCount, count - (size_t)Sensor.GetCounters().SampleCount, Seconds, NoLatencies);
+	std::cout << "replay stream: " << Received << " consumed (zero-copy), " << Sensor.GetCounters().DroppedFrames
+		<< " dropped, checksum " << Checksum << '\n';
+}
+
+// 按录制时间回放：每帧实际可读的时刻与录制时刻之差
+static void BenchReplayRealTime() {
+	static const int64_t TIMES_MS[] = { 0, 10, 50, 51, 52, 80, 120, 125, 200 };
+	const size_t FrameCount = sizeof(TIMES_MS) / sizeof(TIMES_MS[0]);
+	sia::ReplayTransport Transport(true);
+	const char* Frame = "0800080008000800080008000\r\n";
+	for (size_t i = 0; i < FrameCount; i++) {
+		Transport.Append(TIMES_MS[i] * 1000000, Frame, 27);
+	}
+	Transport.Open();
+	const auto Start = BenchClock::now();
+	std::vector<double> Lateness;
+	char Chunk[64];
+	size_t Bytes = 0;
+	while (Lateness.size() < FrameCount) {
+		const int Size = Transport.ReadUntil(Chunk, sizeof(Chunk), '\n', sia::SerialClock::now() + std::chrono::milliseconds(500));
+		if (Size <= 0) {
+			break;
+		}
+		const double ElapsedMs = std::chrono::duration<double, std::milli>(BenchClock::now() - Start).count();
+		Bytes += (size_t)Size;
+		while (Lateness.size() < Bytes / 27) {
+			Lateness.push_back(ElapsedMs - (double)TIMES_MS[Lateness.size()]);
+		}
+	}
+	double MaxLateness = 0.0;
+	for (double Value : Lateness) {
+		MaxLateness = std::max(MaxLateness, Value);
+	}
+	std::cout << "replay real-time: " << Lateness.size() << "/" << FrameCount << " frames, max lateness "
+		<< MaxLateness << " ms\n";
+}
+
+// 记录器：每条记录的写入耗时，以及读取器的遍历及按时刻定位
+static void BenchRecorder(size_t count) {
+	const std::string BasePath = "/tmp/ForceSensorBench";
+	sia::ForceSensorRecorder Recorder(count / 4 + 1);
+	if (!Recorder.Open(BasePath)) {
+		std::cout << "recorder: open failed\n";
+		return;
+	}
+	sia::ForceSensorSample Sample = { {}, 0, 0, 0, sia::SAMPLE_VALID };
+	sia::ForceSensorBuffer Buffer = {};
+	memcpy(Buffer.data(), "0800080008000800080008000\r\n", 27);
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		Sample.ReceiveTimeNs = (int64_t)i * 1000;
+		Sample.Sequence = i + 1;
+		Sample.Data[0] = (float)i;
+		Recorder.Append(Sample, Buffer);
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	const size_t SegmentCount = Recorder.SegmentCount();
+	Recorder.Close();
+	std::cout << "recorder: " << count << " records in " << SegmentCount << " segments, "
+		<< Seconds * 1e9 / (double)count << " ns/record\n";
+
+	sia::ForceSensorRecordReader Reader;
+	if (!Reader.Open(BasePath)) {
+		std::cout << "recorder: reader open failed\n";
+		return;
+	}
+	size_t Mismatch = 0;
+	uint64_t Index = 0;
+	Reader.ForEach([&Mismatch, &Index](const sia::ForceSensorRecord& record) {
+		if (record.Sequence != ++Index || record.Data[0] != (float)(Index - 1)) {
+			Mismatch++;
+		}
+	});
+	sia::ForceSensorRecord Record;
+	Reader.SeekTime((int64_t)(count / 2) * 1000 - 1);
+	const bool SeekOk = Reader.Next(&Record) && Record.Sequence == count / 2 + 1;
+	std::cout << "reader: " << Reader.Size() << " records, " << Mismatch << " mismatched, seek by time "
+		<< (SeekOk ? "ok" : "failed") << '\n';
+	Reader.Close();
+	for (size_t i = 0; i < SegmentCount; i++) {
+		std::remove(sia::RecordSegmentPath(BasePath, i).c_str());
+	}
+}
+
+// 滤波：去皮、4阶低通、滑动平均及抽取全部开启时每个数据的处理耗时
+static void BenchFilter(size_t count) {
+	sia::ForceSensorFilter Filter;
+	Filter.SetLowPass(1000.0, 50.0, 4);
+	Filter.SetMovingAverage(8);
+	Filter.SetDecimation(2);
+	Filter.StartTare(100);
+	sia::ForceSensorData Data;
+	size_t Output = 0;
+	float Residual = 0.0f;
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		for (int j = 0; j < sia::DATA_COUNT; j++) {
+			Data[j] = 10.0f * (float)(j + 1) + (float)((i * 7 + (size_t)j) % 5) * 0.01f;
+		}
+		if (Filter.Process(Data)) {
+			Output++;
+			if (i >= 1000) { // 去皮完成且滤波器稳定之后
+				Residual = std::max(Residual, std::abs(Data[5]));
+			}
+		}
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	std::cout << "filter: " << count << " samples, " << Output << " output, "
+		<< Seconds * 1e9 / (double)count << " ns/sample, bias " << Filter.GetBias()[5]
+		<< ", max residual " << Residual << '\n';
+}
+
+// 标定及工具坐标系变换：工具坐标系绕z轴旋转90度且沿z轴偏移0.1，验证结果并统计每个数据的耗时
+static void BenchWrench(size_t count) {
+	sia::WrenchTransform Transform;
+	Transform.SetToolFrame({ 0.0, -1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0 }, { 0.0, 0.0, 0.1 });
+	sia::ForceSensorData Data = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+	Transform.Process(Data);
+	const bool Ok = std::abs(Data[1] + 1.0f) < 1e-6f && std::abs(Data[3] + 0.1f) < 1e-6f
+		&& std::abs(Data[0]) + std::abs(Data[2]) + std::abs(Data[4]) + std::abs(Data[5]) < 1e-6f;
+	float Acc = 0.0f;
+	auto Start = BenchClock::now();
+	for (size_t i = 0; i < count; i++) {
+		Data = { (float)i, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+		Transform.Process(Data);
+		Acc += Data[5];
+	}
+	double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+	std::cout << "wrench transform: " << (Ok ? "ok" : "wrong result") << ", "
+		<< Seconds * 1e9 / (double)count << " ns/sample (" << Acc << ")\n";
+}
+
+// 文本输出：逐个数通过iostream格式化、operator<<及ForceSensorTextWriter批量写出的每个采样耗时
+static void BenchText(size_t count) {
+	std::vector<sia::ForceSensorSample> Samples(1024);
+	for (size_t i = 0; i < Samples.size(); i++) {
+		sia::ForceSensorSample& Sample = Samples[i];
+		Sample.ReceiveTimeNs = (int64_t)(1000000000ull + i * 1000);
+		Sample.RequestTimeNs = 0;
+		Sample.Sequence = i;
+		Sample.Status = sia::SAMPLE_VALID;
+		for (int j = 0; j < sia::DATA_COUNT; j++) {
+			Sample.Data[j] = (float)((int)((i * 7919 + j * 104729) % 200001) - 100000) / 997.0f;
+		}
+	}
+	auto Run = [count, &Samples](const char* name, const std::function<void(const sia::ForceSensorSample&)>& format) {
+		auto Start = BenchClock::now();
+		for (size_t i = 0; i < count; i++) {
+			format(Samples[i % Samples.size()]);
+		}
+		const double Ns = std::chrono::duration<double, std::nano>(BenchClock::now() - Start).count() / (double)count;
+		std::cout << name << ": " << Ns << " ns/sample\n";
+	};
+	std::ostringstream Stream;
+	Run("text iostream per value", [&Stream](const sia::ForceSensorSample& sample) {
+		if (Stream.tellp() > 65536) {
+			Stream.str("");
+		}
+		Stream << std::fixed << std::setprecision(6);
+		for (auto Value : sample.Data) {
+			Stream << Value << ' ';
+		}
+	});
+	Stream.str("");
+	Run("text operator<<", [&Stream](const sia::ForceSensorSample& sample) {
+		if (Stream.tellp() > 65536) {
+			Stream.str("");
+		}
+		Stream << sample.Data;
+	});
+	sia::ForceSensorTextWriter Writer;
+	if (!Writer.Open("/dev/null")) {
+		std::cout << "text: open failed\n";
+		return;
+	}
+	Run("text writer (csv)", [&Writer](const sia::ForceSensorSample& sample) {
+		Writer.Write(sample);
+	});
+	Writer.Flush();
+	std::cout << "text writer: " << Writer.LineCount() << " lines, " << Writer.WriteCount() << " write() calls\n";
+}
+
+// 批量解析：对比各解码实现的速度
+static void BenchDecode(size_t count) {
+	constexpr size_t FRAME_SIZE = 27;
+	std::vector<char> Frames(count * FRAME_SIZE + 1);
+	for (size_t i = 0; i < count; i++) {
+		char* Frame = &Frames[i * FRAME_SIZE];
+		Frame[0] = (char)('0' + i % 10);
+		for (int j = 0; j < 6; j++) {
+			snprintf(&Frame[1 + 4 * j], 5, "%04X", (unsigned)((i * 7919 + j * 104729) & 0xFFFF));
+		}
+		Frame[25] = '\r';
+		Frame[26] = '\n';
+	}
+	std::vector<sia::ForceSensorSample> Samples(count);
+	sia::DynPick Parser;
+
+	const std::pair<sia::HexDecoderKind, const char*> Kinds[] = {
+		{ sia::HEX_DECODER_SCALAR, "scalar" },
+		{ sia::HEX_DECODER_SSSE3, "ssse3" },
+		{ sia::HEX_DECODER_AVX2, "avx2" },
+	};
+	for (const auto& Kind : Kinds) {
+		if (sia::GetHexDecoder(Kind.first) == sia::GetHexDecoder(sia::HEX_DECODER_SCALAR) && Kind.first != sia::HEX_DECODER_SCALAR) {
+			continue; // CPU不支持
+		}
+		sia::SetHexDecoder(Kind.first);
+		auto Start = BenchClock::now();
+		size_t Valid = Parser.ParseFrames(Frames.data(), count, Samples.data());
+		double Seconds = std::chrono::duration<double>(BenchClock::now() - Start).count();
+		std::cout << "decode " << Kind.second << ": " << Valid << '/' << count << " frames, "
+			<< (double)count / Seconds / 1e6 << " Mframes/s\n";
+	}
+	sia::SetHexDecoder(sia::HEX_DECODER_AUTO);
+}
+
+int main(int argc, char* argv[]) {
+	size_t Count = (argc > 1) ? (size_t)atol(argv[1]) : 10000;
+	sia::DynPickSimulatorConfig SimCfg;
+	SimCfg.ReplyDelayUs = (argc > 2) ? (uint32_t)atol(argv[2]) : 0;
+	SimCfg.CorruptionRate = (argc > 3) ? atof(argv[3]) : 0.0;
+	SimCfg.StreamPeriodUs = 0;
+
+	sia::DynPickSimulator Sim(SimCfg);
+	if (!Sim.Start()) {
+		std::cout << "Simulator Start Fail!\n";
+		return 1;
+	}
+
+	sia::DynPick Sensor({ Sim.SlaveName(), 921600u, 8, 1, 'N' });
+	if (!Sensor.Open() || !Sensor.Init()) {
+		std::cout << "Open/Init Fail!\n";
+		return 1;
+	}
+	sia::SerialSettings Applied;
+	if (static_cast<sia::SerialTransport&>(Sensor.GetTransport()).GetSerialPort().GetAppliedSettings(&Applied)) {
+		std::cout << "serial: " << Applied.OutputBaudrate << '/' << Applied.InputBaudrate << " baud, " << (int)Applied.Databits
+			<< Applied.Parity << (int)Applied.Stopbits << ", raw " << Applied.Raw << ", VMIN " << (int)Applied.ReadMin
+			<< ", low latency " << Applied.LowLatency << ", exclusive " << Applied.Exclusive << '\n';
+	}
+
+	BenchInit(std::max(SimCfg.ReplyDelayUs, 5000u)); // 须在BenchSubscribe之前：其锁定内存（mlockall）后每次创建线程都要预先调入整个栈
+	BenchRequestResponse(Sensor, Count);
+	BenchBasicSensor(Sim.SlaveName(), Count);
+	BenchStream(Sensor, Count);
+	BenchStreamBatch(Sensor, Count);
+	BenchSubscribe(Sensor, Count, true);
+	BenchSubscribe(Sensor, Count, false);
+	BenchSubscribe(Sensor, Count, false, 2);
+	BenchSubscribe(Sensor, Count, false, 4);
+	BenchRate(Sensor, Count / 10, std::chrono::microseconds(500), std::chrono::microseconds(0));
+	BenchRate(Sensor, Count / 10, std::chrono::microseconds(500), std::chrono::microseconds(50));
+	BenchReactor(SimCfg, Count);
+	BenchAggregator(Count / 10);
+	BenchLoopback(Count * 10);
+	BenchReplay(Count * 100);
+	BenchReplayRealTime();
+	BenchBroadcast(Count * 100);
+	BenchSharedMemory(Count / 4);
+	BenchRecorder(Count * 100);
+	BenchFilter(Count * 100);
+	BenchWrench(Count * 100);
+	BenchText(Count * 10);
+	BenchDecode(Count * 100);
+	sia::ForceSensorCounters Counters = Sensor.GetCounters();
+	std::cout << "retries: " << Counters.Retries << ", timeouts: " << Counters.Timeouts
+		<< ", parse failures: " << Counters.ParseFailures << ", dropped: " << Counters.DroppedFrames
+		<< ", discarded bytes: " << Counters.DiscardedBytes
+		<< ", corrupted frames: " << Sim.CorruptedFrameCount() << '\n';
+
+	Sensor.Close();
+	Sim.Stop();
+	return 0;
+}
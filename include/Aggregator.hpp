@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "ForceSensor.hpp"
+#include "Filter.hpp"
+
+namespace sia {
+	static constexpr size_t AGGREGATOR_MAX_SENSORS = 8;     // 最多聚合的传感器数
+	static constexpr size_t AGGREGATOR_HISTORY_SIZE = 16;   // 每个传感器保留的最近采样数，用于插值
+	static constexpr int AGGREGATOR_STRIDE = FILTER_LANE_COUNT; // 帧中每个传感器的数据按SIMD宽度补齐为8个
+
+	// 每个传感器在对齐时刻的数据来源
+	enum AggregateStatus {
+		AGGREGATE_INTERPOLATED = 0, // 由对齐时刻前后的两个采样线性插值（或恰好为一个采样）
+		AGGREGATE_HELD,             // 对齐时刻之后尚无采样，沿用最新的采样，未超过最大时差
+		AGGREGATE_EARLIEST,         // 对齐时刻早于保留的最早采样，使用最早的采样，未超过最大时差
+		AGGREGATE_STALE,            // 最接近的采样与对齐时刻相差超过最大时差，数据仍为该采样
+		AGGREGATE_NO_DATA           // 尚未收到采样，数据为0
+	};
+
+	// 多传感器对齐后的一帧
+	// Data按传感器依次连续存放，每个传感器8个数（6个有效，其余为0），第i个传感器的数据从Data[i * AGGREGATOR_STRIDE]开始，
+	// 可直接用LanesLoad/SIMD按传感器或整块处理。
+	struct AggregatedFrame {
+		std::array<float, AGGREGATOR_MAX_SENSORS * AGGREGATOR_STRIDE> Data; // N×8，补齐部分为0
+		int64_t TimeNs;                                                     // 对齐时刻，与ForceSensorSample::ReceiveTimeNs同一时钟
+		uint64_t Tick;                                                      // 帧序号，从1开始
+		uint32_t SensorCount;                                               // 有效的传感器数
+		uint32_t StaleMask;                                                 // 第i位为1表示第i个传感器为AGGREGATE_STALE或AGGREGATE_NO_DATA
+		std::array<AggregateStatus, AGGREGATOR_MAX_SENSORS> Status;         // 各传感器的数据来源
+		std::array<int64_t, AGGREGATOR_MAX_SENSORS> AgeNs;                  // 对齐时刻减去最近的已用采样时刻（插值时为前一个采样）
+		std::array<uint64_t, AGGREGATOR_MAX_SENSORS> Sequence;              // 最近的已用采样的序号
+
+		const float* Sensor(size_t index) const {
+			return &Data[index * AGGREGATOR_STRIDE];
+		}
+		bool IsStale(size_t index) const {
+			return (StaleMask >> index) & 1u;
+		}
+	};
+
+	// 多传感器时间对齐：每次Tick将各传感器的采样对齐到同一时刻，生成一个连续存放的N×6（补齐为N×8）帧
+	// 每个传感器通过各自的广播消费者读取采样（ForceSensor::MakeReader），不影响采集及其他消费者，任何读取方式（连续输出、订阅、请求应答）均可。
+	// 各传感器的采样时刻为ReceiveTimeNs，均为单调时钟，对齐时刻前后各有一个采样时线性插值，否则取最接近的采样并标记来源。
+	// 在一个线程中使用，Tick不分配内存，返回的帧在下一次Tick前有效。
+	class ForceSensorAggregator {
+	public:
+		// maxAgeNs：最接近的采样与对齐时刻的最大时差，超过时标记为过时；delayNs：Tick()默认对齐到 当前时刻 - delayNs，
+		// 延迟约一个采样周期时各传感器的对齐时刻之后通常已有采样，可以插值而不是沿用旧的采样
+		explicit ForceSensorAggregator(int64_t maxAgeNs = 5000000, int64_t delayNs = 0)
+			: m_MaxAgeNs(maxAgeNs), m_DelayNs(delayNs) {
+			m_Sensors.reserve(AGGREGATOR_MAX_SENSORS);
+			m_Frame.Data.fill(0.0f);
+			m_Frame.TimeNs = 0;
+			m_Frame.Tick = 0;
+			m_Frame.SensorCount = 0;
+			m_Frame.StaleMask = 0;
+			m_Frame.Status.fill(AGGREGATE_NO_DATA);
+			m_Frame.AgeNs.fill(0);
+			m_Frame.Sequence.fill(0);
+		}
+		ForceSensorAggregator(const ForceSensorAggregator& other) = delete;
+		ForceSensorAggregator& operator=(const ForceSensorAggregator& other) = delete;
+
+		// 添加一个传感器，返回其在帧中的序号，已满时返回-1。从添加之后的采样开始聚合，传感器的生命周期由调用者管理
+		int Add(const ForceSensor& sensor) {
+			if (m_Sensors.size() >= AGGREGATOR_MAX_SENSORS) {
+				return -1;
+			}
+			m_Sensors.emplace_back(sensor.MakeReader());
+			m_Frame.SensorCount = (uint32_t)m_Sensors.size();
+			return (int)m_Sensors.size() - 1;
+		}
+		size_t SensorCount() const {
+			return m_Sensors.size();
+		}
+		void SetMaxAge(int64_t maxAgeNs) {
+			m_MaxAgeNs = maxAgeNs;
+		}
+		void SetDelay(int64_t delayNs) {
+			m_DelayNs = delayNs;
+		}
+
+		// 对齐到 当前时刻 - delayNs
+		const AggregatedFrame& Tick() {
+			return Tick(MonotonicNs() - m_DelayNs);
+		}
+		// 对齐到timeNs（单调时钟，纳秒）
+		const AggregatedFrame& Tick(int64_t timeNs) {
+			m_Frame.TimeNs = timeNs;
+			m_Frame.Tick++;
+			m_Frame.StaleMask = 0;
+			for (size_t i = 0; i < m_Sensors.size(); i++) {
+				SensorChannel& Channel = m_Sensors[i];
+				Channel.Drain();
+				const AggregateStatus Status = Channel.Align(timeNs, m_MaxAgeNs, &m_Frame.Data[i * AGGREGATOR_STRIDE], &m_Frame.AgeNs[i], &m_Frame.Sequence[i]);
+				m_Frame.Status[i] = Status;
+				if (Status == AGGREGATE_STALE || Status == AGGREGATE_NO_DATA) {
+					m_Frame.StaleMask |= 1u << i;
+				}
+			}
+			return m_Frame;
+		}
+		const AggregatedFrame& Frame() const {
+			return m_Frame;
+		}
+		// 第index个传感器因读取过慢被覆盖而丢失的采样数
+		uint64_t LostCount(size_t index) const {
+			return (index < m_Sensors.size()) ? m_Sensors[index].Reader.LostCount() : 0;
+		}
+
+	private:
+		// 一个传感器最近的采样，数据按8个补齐，插值时整行做一次SIMD运算
+		struct SensorChannel {
+			explicit SensorChannel(const ForceSensorReader& reader) : Reader(reader) {}
+
+			// 取出广播缓冲区中的新采样，只保留最近的AGGREGATOR_HISTORY_SIZE个
+			void Drain() {
+				ForceSensorSample Sample;
+				while (Reader.Next(&Sample)) {
+					const size_t Slot = (size_t)(Count % AGGREGATOR_HISTORY_SIZE);
+					TimeNs[Slot] = Sample.ReceiveTimeNs;
+					Sequence[Slot] = Sample.Sequence;
+					float* Row = &Data[Slot * AGGREGATOR_STRIDE];
+					for (int j = 0; j < DATA_COUNT; j++) {
+						Row[j] = Sample.Data[j];
+					}
+					Count++;
+				}
+			}
+			// 将对齐时刻的数据写入out（8个）
+			AggregateStatus Align(int64_t timeNs, int64_t maxAgeNs, float* out, int64_t* pAgeNs, uint64_t* pSequence) const {
+				if (Count == 0) {
+					LanesStore(out, LanesSet(0.0f));
+					*pAgeNs = 0;
+					*pSequence = 0;
+					return AGGREGATE_NO_DATA;
+				}
+				const uint64_t Oldest = (Count > AGGREGATOR_HISTORY_SIZE) ? Count - AGGREGATOR_HISTORY_SIZE : 0;
+				uint64_t Newer = Count; // 第一个晚于对齐时刻的采样
+				while (Newer > Oldest && TimeNs[(Newer - 1) % AGGREGATOR_HISTORY_SIZE] > timeNs) {
+					Newer--;
+				}
+				AggregateStatus Status;
+				size_t Used;
+				int64_t Distance = 0; // 与最接近的已用采样的时差
+				if (Newer == Count) { // 对齐时刻之后尚无采样
+					Used = (size_t)((Count - 1) % AGGREGATOR_HISTORY_SIZE);
+					LanesStore(out, LanesLoad(&Data[Used * AGGREGATOR_STRIDE]));
+					Status = (TimeNs[Used] == timeNs) ? AGGREGATE_INTERPOLATED : AGGREGATE_HELD;
+				}
+				else if (Newer == Oldest) { // 早于保留的最早采样
+					Used = (size_t)(Oldest % AGGREGATOR_HISTORY_SIZE);
+					LanesStore(out, LanesLoad(&Data[Used * AGGREGATOR_STRIDE]));
+					Status = AGGREGATE_EARLIEST;
+				}
+				else { // 前后各有一个采样：a + (b - a) * w
+					Used = (size_t)((Newer - 1) % AGGREGATOR_HISTORY_SIZE);
+					const size_t Next = (size_t)(Newer % AGGREGATOR_HISTORY_SIZE);
+					const int64_t Span = TimeNs[Next] - TimeNs[Used];
+					const float Weight = (Span > 0) ? (float)((double)(timeNs - TimeNs[Used]) / (double)Span) : 0.0f;
+					const FilterLanes A = LanesLoad(&Data[Used * AGGREGATOR_STRIDE]);
+					const FilterLanes B = LanesLoad(&Data[Next * AGGREGATOR_STRIDE]);
+					LanesStore(out, A + (B - A) * LanesSet(Weight));
+					Status = AGGREGATE_INTERPOLATED;
+					Distance = std::min(timeNs - TimeNs[Used], TimeNs[Next] - timeNs); // 两个采样间隔过长（如中途断线）时同样视为过时
+				}
+				*pAgeNs = timeNs - TimeNs[Used];
+				*pSequence = Sequence[Used];
+				if (Status != AGGREGATE_INTERPOLATED) {
+					Distance = (*pAgeNs >= 0) ? *pAgeNs : -*pAgeNs;
+				}
+				if (Distance > maxAgeNs) {
+					Status = AGGREGATE_STALE;
+				}
+				return Status;
+			}
+
+			ForceSensorReader Reader;
+			uint64_t Count = 0; // 已取出的采样总数
+			std::array<int64_t, AGGREGATOR_HISTORY_SIZE> TimeNs = {};
+			std::array<uint64_t, AGGREGATOR_HISTORY_SIZE> Sequence = {};
+			std::array<float, AGGREGATOR_HISTORY_SIZE * AGGREGATOR_STRIDE> Data = {};
+		};
+
+		int64_t m_MaxAgeNs;
+		int64_t m_DelayNs;
+		std::vector<SensorChannel> m_Sensors;
+		AggregatedFrame m_Frame;
+	};
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <utility>
+#include "ForceSensor.hpp"
+
+namespace sia {
+	// 编译期绑定协议与传输层的力传感器
+	// 与ForceSensor相比没有虚函数调用，指令为编译期常量，请求-读取-解析整个过程可被内联且无堆内存分配。
+	//
+	// Protocol需提供：
+	//   TERMINATOR、DATA_FRAME_SIZE、SCALE_FRAME_SIZE、MAX_FRAME_SIZE、SCALE_CMD 常量
+	//   SCALE_COUNT 常量                                                           Decode/ParseScale使用的比例系数数组长度
+	//   static constexpr char Command(ForceSensorCommonCmd)                        通用指令对应的命令字节，0表示不支持
+	//   static bool Decode(const char* frame, const float* scale, float* data)      解析数据帧
+	//   static bool ParseScale(const char* frame, size_t size, float* scale)        解析比例系数帧
+	// Port需提供与SerialPort相同的Open、Close、IsOpen、Write、ReadUntil接口。
+	template <typename Protocol, typename Port = SerialPort>
+	class BasicForceSensor {
+	public:
+		template <typename... Args>
+		explicit BasicForceSensor(Args&&... args) : m_Transport(std::forward<Args>(args)...) {
+			m_Assembler.SetFormat(Protocol::TERMINATOR, { Protocol::DATA_FRAME_SIZE, Protocol::SCALE_FRAME_SIZE });
+			m_Scale.fill(1.0f);
+		}
+		BasicForceSensor(const BasicForceSensor& other) = delete;
+		BasicForceSensor& operator=(const BasicForceSensor& other) = delete;
+		~BasicForceSensor() { Close(); }
+
+		bool Open() {
+			return m_Transport.Open();
+		}
+		bool IsOpen() const {
+			return m_Transport.IsOpen();
+		}
+		void Close() {
+			m_Transport.Close();
+		}
+		Port& GetTransport() {
+			return m_Transport;
+		}
+
+		// 读取比例系数（如DynPick的灵敏度），最多尝试maxCount次
+		bool Init(const uint8_t& maxCount = 5) {
+			if (!IsOpen()) {
+				return false;
+			}
+			if (Protocol::Command(Protocol::SCALE_CMD) == '\0') { // 协议没有比例系数
+				return true;
+			}
+			for (uint8_t i = 0; i < maxCount; i++) {
+				bool Ret = false;
+				if (SendCmd(Protocol::SCALE_CMD)) {
+					WaitFrames(Protocol::SCALE_FRAME_SIZE, [this, &Ret](const char* frame, size_t size) {
+						Ret = Protocol::ParseScale(frame, size, m_Scale.data());
+					});
+				}
+				if (Ret) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool SendCmd(ForceSensorCommonCmd commCmd) {
+			const char Cmd = Protocol::Command(commCmd);
+			if (Cmd == '\0') {
+				return false;
+			}
+			m_LastRequestNs = MonotonicNs();
+			return m_Transport.Write(&Cmd, 1) == 1;
+		}
+
+		// 请求一次数据，成功时写入pSample
+		bool Update(ForceSensorSample* pSample) {
+			if (!SendCmd(REQUEST_SEND_DATA_ONCE)) {
+				pSample->Status = SAMPLE_SEND_ERROR;
+				return false;
+			}
+			bool Received = false;
+			bool Ret = false;
+			WaitFrames(Protocol::DATA_FRAME_SIZE, [this, pSample, &Received, &Ret](const char* frame, size_t) {
+				Received = true;
+				Ret = Protocol::Decode(frame, m_Scale.data(), pSample->Data.data());
+			});
+			pSample->RequestTimeNs = m_LastRequestNs;
+			pSample->ReceiveTimeNs = m_LastReceiveNs;
+			if (!Ret) {
+				pSample->Status = Received ? SAMPLE_PARSE_ERROR : SAMPLE_TIMEOUT;
+				return false;
+			}
+			pSample->Sequence = ++m_Sequence;
+			pSample->Status = SAMPLE_VALID;
+			return true;
+		}
+		// 请求数据，失败时重复尝试，最多maxCount次
+		bool UpdateUntilCorrect(ForceSensorSample* pSample, const uint8_t& maxCount = 10) {
+			bool Ret = false;
+			uint8_t Count = 0;
+			do {
+				Ret = Update(pSample);
+			} while (!Ret && Count++ < maxCount);
+			return Ret;
+		}
+
+		ForceSensorSample ReadSample() {
+			if (UpdateUntilCorrect(&m_Sample)) {
+				return m_Sample;
+			}
+			ForceSensorSample Sample = m_Sample;
+			Sample.Data = {};
+			return Sample;
+		}
+		ForceSensorData ReadData() {
+			if (UpdateUntilCorrect(&m_Sample)) {
+				return m_Sample.Data;
+			}
+			return {};
+		}
+		// 获取最近一次的采样，仅可在读取线程中调用
+		const ForceSensorSample& GetSample() const {
+			return m_Sample;
+		}
+
+		void SetReplyTimeout(const uint32_t& timeoutMs) {
+			m_ReplyTimeout = std::chrono::milliseconds(timeoutMs);
+		}
+
+	private:
+		static constexpr int READ_CHUNK_SIZE = 256;
+
+		// 等待长度为frameSize的帧，对每个该长度的帧调用onFrame，直到收到至少一个或超时
+		template <typename OnFrame>
+		void WaitFrames(size_t frameSize, OnFrame&& onFrame) {
+			bool Found = false;
+			char Chunk[READ_CHUNK_SIZE];
+			const SerialTimePoint Deadline = SerialClock::now() + m_ReplyTimeout;
+			do {
+				int ReadByteCount = m_Transport.ReadUntil(Chunk, READ_CHUNK_SIZE, Protocol::TERMINATOR, Deadline);
+				if (ReadByteCount <= 0) {
+					break;
+				}
+				m_LastReceiveNs = MonotonicNs();
+				m_Assembler.Feed(Chunk, ReadByteCount, [frameSize, &onFrame, &Found](const char* frame, size_t size) {
+					if (size == frameSize) {
+						onFrame(frame, size);
+						Found = true;
+					}
+				});
+			} while (!Found);
+		}
+
+	private:
+		Port m_Transport;
+		FrameAssembler<Protocol::MAX_FRAME_SIZE> m_Assembler;
+		std::array<float, Protocol::SCALE_COUNT> m_Scale;
+		ForceSensorSample m_Sample = { {}, 0, 0, 0, SAMPLE_NO_DATA };
+		std::chrono::milliseconds m_ReplyTimeout{ REPLY_TIMEOUT_MS };
+		int64_t m_LastRequestNs = 0;
+		int64_t m_LastReceiveNs = 0;
+		uint64_t m_Sequence = 0;
+	};
+}
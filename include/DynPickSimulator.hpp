@@ -0,0 +1,226 @@
+#pragma once
+
+#ifndef WIN32
+#include <pty.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace sia {
+	// DynPick模拟器参数
+	struct DynPickSimulatorConfig {
+		uint32_t ReplyDelayUs = 0;     // 收到指令到开始应答的延时，微秒
+		uint32_t StreamPeriodUs = 1000; // 连续输出模式下的发送周期，微秒，0表示尽可能快
+		double CorruptionRate = 0.0;   // 每帧被注入错误（改写、丢失或插入字节）的概率
+		uint32_t Seed = 1;             // 随机数种子，保证测试可复现
+	};
+
+	// 基于伪终端的DynPick传感器模拟器，仅Linux
+	// 在后台线程中应答'R'（27字节数据帧）、'p'（49字节灵敏度）及'S'/'E'（开始/停止连续输出）。
+	// 将SlaveName()作为SerialConfig::PortName即可像真实传感器一样使用。
+	class DynPickSimulator {
+	public:
+		explicit DynPickSimulator(const DynPickSimulatorConfig& cfg = DynPickSimulatorConfig()) : m_Config(cfg), m_Random(cfg.Seed) {}
+		DynPickSimulator(const DynPickSimulator& other) = delete;
+		DynPickSimulator& operator=(const DynPickSimulator& other) = delete;
+		~DynPickSimulator() { Stop(); }
+
+		// 创建伪终端并启动应答线程
+		bool Start() {
+			if (m_Running) {
+				return true;
+			}
+			char Name[128] = { 0 };
+			if (openpty(&m_MasterFd, &m_SlaveFd, Name, nullptr, nullptr) != 0) {
+				return false;
+			}
+			m_SlaveName = Name;
+			// 两端均设为原始模式，避免'\r'被翻译或回显
+			struct termios Opt;
+			tcgetattr(m_SlaveFd, &Opt);
+			cfmakeraw(&Opt);
+			tcsetattr(m_SlaveFd, TCSANOW, &Opt);
+			tcgetattr(m_MasterFd, &Opt);
+			cfmakeraw(&Opt);
+			tcsetattr(m_MasterFd, TCSANOW, &Opt);
+			// 与真实串口一样，对端来不及读取时丢弃数据而不是阻塞
+			fcntl(m_MasterFd, F_SETFL, fcntl(m_MasterFd, F_GETFL) | O_NONBLOCK);
+
+			m_Running = true;
+			m_Thread = std::thread(&DynPickSimulator::Loop, this);
+			return true;
+		}
+		void Stop() {
+			m_Running = false;
+			if (m_Thread.joinable()) {
+				m_Thread.join();
+			}
+			if (m_MasterFd >= 0) {
+				close(m_MasterFd);
+				m_MasterFd = -1;
+			}
+			if (m_SlaveFd >= 0) {
+				close(m_SlaveFd);
+				m_SlaveFd = -1;
+			}
+		}
+
+		// 伪终端从设备名，作为串口名使用
+		const std::string& SlaveName() const {
+			return m_SlaveName;
+		}
+		uint64_t CommandCount() const {
+			return m_CommandCount;
+		}
+		uint64_t FrameCount() const {
+			return m_FrameCount;
+		}
+		uint64_t CorruptedFrameCount() const {
+			return m_CorruptedFrameCount;
+		}
+		uint64_t OverrunBytes() const {
+			return m_OverrunBytes;
+		}
+
+		// 模拟器使用的灵敏度，用于校验解析结果
+		static constexpr const char* LSB_LINE = "32.800,32.815,32.835,1653.801,1634.136,1636.643\r\n";
+
+	private:
+		static constexpr size_t DATA_FRAME_SIZE = 27;
+		static constexpr int POLL_INTERVAL_MS = 10;
+
+		void Loop() {
+			char Cmd[64];
+			auto NextStreamTime = std::chrono::steady_clock::now();
+			while (m_Running) {
+				std::chrono::nanoseconds Timeout(POLL_INTERVAL_MS * 1000000LL);
+				if (m_Streaming) {
+					auto Now = std::chrono::steady_clock::now();
+					if (Now >= NextStreamTime) {
+						SendDataFrame();
+						NextStreamTime += std::chrono::microseconds(m_Config.StreamPeriodUs);
+						if (NextStreamTime < Now) { // 落后太多时不补发
+							NextStreamTime = Now;
+						}
+					}
+					// 按纳秒等待到下一帧的时刻，周期小于1毫秒时不会因取整为0而忙等
+					Timeout = std::max(std::chrono::nanoseconds(0), std::chrono::duration_cast<std::chrono::nanoseconds>(NextStreamTime - Now));
+				}
+				const struct timespec Ts = { (time_t)(Timeout.count() / 1000000000), (long)(Timeout.count() % 1000000000) };
+				struct pollfd Pfd = { m_MasterFd, POLLIN, 0 };
+				if (ppoll(&Pfd, 1, &Ts, nullptr) <= 0 || !(Pfd.revents & POLLIN)) {
+					continue;
+				}
+				int Count = (int)read(m_MasterFd, Cmd, sizeof(Cmd));
+				for (int i = 0; i < Count; i++) {
+					HandleCmd(Cmd[i]);
+				}
+				if (m_Streaming && NextStreamTime < std::chrono::steady_clock::now()) {
+					NextStreamTime = std::chrono::steady_clock::now();
+				}
+			}
+		}
+
+		void HandleCmd(char cmd) {
+			m_CommandCount++;
+			switch (cmd) {
+			case 'R':
+				Delay();
+				SendDataFrame();
+				break;
+			case 'p':
+				Delay();
+				WriteAll(LSB_LINE, strlen(LSB_LINE));
+				break;
+			case 'S':
+				m_Streaming = true;
+				break;
+			case 'E':
+				m_Streaming = false;
+				break;
+			default:
+				break;
+			}
+		}
+
+		void Delay() const {
+			if (m_Config.ReplyDelayUs > 0) {
+				std::this_thread::sleep_for(std::chrono::microseconds(m_Config.ReplyDelayUs));
+			}
+		}
+
+		// 生成一帧数据：1位记录号 + 6x4位十六进制 + "\r\n"
+		void SendDataFrame() {
+			char Frame[DATA_FRAME_SIZE + 1];
+			Frame[0] = (char)('0' + (m_FrameCount % 10));
+			for (int i = 0; i < 6; i++) {
+				int Value = 8192 + (int)(4000.0 * std::sin(0.001 * (double)m_FrameCount + i));
+				snprintf(&Frame[1 + 4 * i], 5, "%04X", Value & 0xFFFF);
+			}
+			Frame[25] = '\r';
+			Frame[26] = '\n';
+			m_FrameCount++;
+
+			size_t Size = DATA_FRAME_SIZE;
+			if (m_Config.CorruptionRate > 0.0 && m_Uniform(m_Random) < m_Config.CorruptionRate) {
+				Size = Corrupt(Frame, Size);
+				m_CorruptedFrameCount++;
+			}
+			WriteAll(Frame, Size);
+		}
+		// 随机改写、丢弃或插入一个字节，返回新的帧长度
+		size_t Corrupt(char* frame, size_t size) {
+			size_t Pos = m_Random() % (size - 1);
+			switch (m_Random() % 3) {
+			case 0:
+				frame[Pos] = 'Z';
+				return size;
+			case 1:
+				memmove(&frame[Pos], &frame[Pos + 1], size - Pos - 1);
+				return size - 1;
+			default:
+				memmove(&frame[Pos + 1], &frame[Pos], size - Pos);
+				frame[Pos] = '?';
+				return size + 1;
+			}
+		}
+
+		void WriteAll(const char* data, size_t count) {
+			while (count > 0) {
+				ssize_t Ret = write(m_MasterFd, data, count);
+				if (Ret <= 0) { // 缓冲区已满
+					m_OverrunBytes += count;
+					return;
+				}
+				data += Ret;
+				count -= (size_t)Ret;
+			}
+		}
+
+	private:
+		DynPickSimulatorConfig m_Config;
+		std::mt19937 m_Random;
+		std::uniform_real_distribution<double> m_Uniform{ 0.0, 1.0 };
+		int m_MasterFd = -1;
+		int m_SlaveFd = -1;
+		std::string m_SlaveName;
+		std::thread m_Thread;
+		std::atomic<bool> m_Running{ false };
+		std::atomic<bool> m_Streaming{ false };
+		std::atomic<uint64_t> m_CommandCount{ 0 };
+		std::atomic<uint64_t> m_FrameCount{ 0 };
+		std::atomic<uint64_t> m_CorruptedFrameCount{ 0 };
+		std::atomic<uint64_t> m_OverrunBytes{ 0 };
+	};
+}
+#endif // WIN32
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include "ForceSensor.hpp"
+#include "SeqLock.hpp"
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SIA_FILTER_SSE // x86平台用两个SSE寄存器存放8个通道，其它平台使用标量实现
+#endif
+
+namespace sia {
+	static constexpr int FILTER_LANE_COUNT = 8;          // 6个通道按SIMD宽度补齐为8个
+	static constexpr int FILTER_MAX_BIQUAD_COUNT = 2;    // 最多串联的二阶节数，即最高4阶
+	static constexpr uint32_t FILTER_MAX_WINDOW = 64;    // 滑动平均的最大窗口长度
+
+	// 8个通道的数据，滤波的每一步都是对8个通道的同一运算
+#ifdef SIA_FILTER_SSE
+	struct FilterLanes {
+		__m128 Lo, Hi;
+	};
+	inline FilterLanes LanesLoad(const float* p) {
+		return { _mm_loadu_ps(p), _mm_loadu_ps(p + 4) };
+	}
+	inline void LanesStore(float* p, const FilterLanes& v) {
+		_mm_storeu_ps(p, v.Lo);
+		_mm_storeu_ps(p + 4, v.Hi);
+	}
+	inline FilterLanes LanesSet(float v) {
+		return { _mm_set1_ps(v), _mm_set1_ps(v) };
+	}
+	inline FilterLanes operator+(const FilterLanes& a, const FilterLanes& b) {
+		return { _mm_add_ps(a.Lo, b.Lo), _mm_add_ps(a.Hi, b.Hi) };
+	}
+	inline FilterLanes operator-(const FilterLanes& a, const FilterLanes& b) {
+		return { _mm_sub_ps(a.Lo, b.Lo), _mm_sub_ps(a.Hi, b.Hi) };
+	}
+	inline FilterLanes operator*(const FilterLanes& a, const FilterLanes& b) {
+		return { _mm_mul_ps(a.Lo, b.Lo), _mm_mul_ps(a.Hi, b.Hi) };
+	}
+#else
+	struct FilterLanes {
+		float V[FILTER_LANE_COUNT];
+	};
+	inline FilterLanes LanesLoad(const float* p) {
+		FilterLanes Ret;
+		memcpy(Ret.V, p, sizeof(Ret.V));
+		return Ret;
+	}
+	inline void LanesStore(float* p, const FilterLanes& v) {
+		memcpy(p, v.V, sizeof(v.V));
+	}
+	inline FilterLanes LanesSet(float v) {
+		FilterLanes Ret;
+		for (int i = 0; i < FILTER_LANE_COUNT; i++) {
+			Ret.V[i] = v;
+		}
+		return Ret;
+	}
+	inline FilterLanes operator+(const FilterLanes& a, const FilterLanes& b) {
+		FilterLanes Ret;
+		for (int i = 0; i < FILTER_LANE_COUNT; i++) {
+			Ret.V[i] = a.V[i] + b.V[i];
+		}
+		return Ret;
+	}
+	inline FilterLanes operator-(const FilterLanes& a, const FilterLanes& b) {
+		FilterLanes Ret;
+		for (int i = 0; i < FILTER_LANE_COUNT; i++) {
+			Ret.V[i] = a.V[i] - b.V[i];
+		}
+		return Ret;
+	}
+	inline FilterLanes operator*(const FilterLanes& a, const FilterLanes& b) {
+		FilterLanes Ret;
+		for (int i = 0; i < FILTER_LANE_COUNT; i++) {
+			Ret.V[i] = a.V[i] * b.V[i];
+		}
+		return Ret;
+	}
+#endif // SIA_FILTER_SSE
+
+	// 二阶节系数，已按a0归一化，A[0]恒为1：y = B[0]*x + B[1]*x1 + B[2]*x2 - A[1]*y1 - A[2]*y2
+	// （不使用B0等名称，termios.h中B0为宏）
+	struct BiquadCoeffs {
+		float B[3];
+		float A[3];
+	};
+
+	// 二阶Butterworth低通节（双线性变换），q为品质因数
+	inline BiquadCoeffs LowPassBiquad(double sampleRateHz, double cutoffHz, double q) {
+		const double W0 = 2.0 * 3.14159265358979323846 * cutoffHz / sampleRateHz;
+		const double Cos = std::cos(W0);
+		const double Alpha = std::sin(W0) / (2.0 * q);
+		const double A0 = 1.0 + Alpha;
+		return { { (float)((1.0 - Cos) / 2.0 / A0), (float)((1.0 - Cos) / A0), (float)((1.0 - Cos) / 2.0 / A0) },
+			{ 1.0f, (float)(-2.0 * Cos / A0), (float)((1.0 - Alpha) / A0) } };
+	}
+
+	// 6轴实时滤波：去皮 -> 低通（二阶节串联） -> 滑动平均 -> N:1抽取
+	// 状态按结构体数组（SoA）存放，每个变量的8个通道（6个有效）连续存放，每一步对所有通道做一次SIMD运算。
+	// Process须在读取线程中调用；配置须在开始读取前完成，StartTare及GetBias可在任意线程中调用。
+	class ForceSensorFilter : public ForceSensorStage {
+	public:
+		explicit ForceSensorFilter() : m_PublishedBias(ForceSensorData{}) {
+			m_Bias = LanesSet(0.0f);
+			Reset();
+		}
+
+		// 去皮：对之后的sampleCount个数据求平均作为零点，完成后减去零点并重新开始滤波
+		void StartTare(uint32_t sampleCount) {
+			m_TareRequest.store(sampleCount > 0 ? sampleCount : 1, std::memory_order_release);
+		}
+		bool IsTaring() const {
+			return m_TareRequest.load(std::memory_order_acquire) != 0 || m_TareRemaining.load(std::memory_order_acquire) != 0;
+		}
+		// 直接设置零点，须在开始读取前或在读取线程中调用
+		void SetBias(const ForceSensorData& bias) {
+			float Bias[FILTER_LANE_COUNT] = {};
+			for (int i = 0; i < DATA_COUNT; i++) {
+				Bias[i] = bias[i];
+			}
+			m_Bias = LanesLoad(Bias);
+			m_PublishedBias.Store(bias);
+			m_Primed = false;
+		}
+		ForceSensorData GetBias() const {
+			return m_PublishedBias.Load();
+		}
+
+		// 低通：order为2或4阶Butterworth，cutoffHz须小于sampleRateHz的一半，cutoffHz为0表示关闭
+		bool SetLowPass(double sampleRateHz, double cutoffHz, int order = 2) {
+			if (cutoffHz <= 0.0) {
+				m_BiquadCount = 0;
+				return true;
+			}
+			if (sampleRateHz <= 0.0 || cutoffHz >= sampleRateHz / 2.0 || (order != 2 && order != 4)) {
+				return false;
+			}
+			if (order == 2) {
+				SetBiquad(0, LowPassBiquad(sampleRateHz, cutoffHz, 0.70710678));
+				m_BiquadCount = 1;
+			}
+			else { // 4阶Butterworth分解为两个二阶节
+				SetBiquad(0, LowPassBiquad(sampleRateHz, cutoffHz, 0.54119610));
+				SetBiquad(1, LowPassBiquad(sampleRateHz, cutoffHz, 1.30656296));
+				m_BiquadCount = 2;
+			}
+			m_Primed = false;
+			return true;
+		}
+		// 使用自定义的二阶节，须为直流增益为1的低通，否则首个数据的初始化会产生过渡过程
+		bool SetBiquads(const BiquadCoeffs* pCoeffs, int count) {
+			if (count < 0 || count > FILTER_MAX_BIQUAD_COUNT) {
+				return false;
+			}
+			for (int i = 0; i < count; i++) {
+				SetBiquad(i, pCoeffs[i]);
+			}
+			m_BiquadCount = count;
+			m_Primed = false;
+			return true;
+		}
+		// 滑动平均：window为1表示关闭
+		bool SetMovingAverage(uint32_t window) {
+			if (window == 0 || window > FILTER_MAX_WINDOW) {
+				return false;
+			}
+			m_Window = window;
+			m_InvWindow = LanesSet(1.0f / (float)window);
+			m_Primed = false;
+			return true;
+		}
+		// 抽取：每factor个数据输出一个，factor为1表示关闭
+		bool SetDecimation(uint32_t factor) {
+			if (factor == 0) {
+				return false;
+			}
+			m_Decimation = factor;
+			m_DecimationCount = 0;
+			return true;
+		}
+
+		// 清空滤波状态，保留配置及零点，下一个数据重新初始化
+		void Reset() {
+			m_Primed = false;
+			m_DecimationCount = 0;
+		}
+
+		// 处理一个数据，原地输出，返回false表示该数据被抽取掉
+		bool Process(ForceSensorData& data) override {
+			float Buffer[FILTER_LANE_COUNT] = {};
+			memcpy(Buffer, data.data(), sizeof(float) * DATA_COUNT);
+			UpdateTare(Buffer);
+			FilterLanes X = LanesLoad(Buffer) - m_Bias;
+			if (!m_Primed) {
+				Prime(X);
+			}
+			for (int s = 0; s < m_BiquadCount; s++) {
+				const Biquad& Bq = m_Biquads[s];
+				const FilterLanes Y = Bq.Ff0 * X + m_Z1[s];
+				m_Z1[s] = Bq.Ff1 * X - Bq.Fb1 * Y + m_Z2[s];
+				m_Z2[s] = Bq.Ff2 * X - Bq.Fb2 * Y;
+				X = Y;
+			}
+			if (m_Window > 1) {
+				X = RunMovingAverage(X);
+			}
+			if (++m_DecimationCount < m_Decimation) {
+				return false;
+			}
+			m_DecimationCount = 0;
+			LanesStore(Buffer, X);
+			memcpy(data.data(), Buffer, sizeof(float) * DATA_COUNT);
+			return true;
+		}
+		bool Process(const ForceSensorData& in, ForceSensorData* pOut) {
+			*pOut = in;
+			return Process(*pOut);
+		}
+
+	private:
+		// 二阶节系数广播到8个通道，转置直接II型：y = b0*x + z1, z1 = b1*x - a1*y + z2, z2 = b2*x - a2*y
+		struct Biquad {
+			FilterLanes Ff0, Ff1, Ff2, Fb1, Fb2; // 前馈系数b0~b2及反馈系数a1、a2
+		};
+
+		void SetBiquad(int index, const BiquadCoeffs& c) {
+			m_Biquads[index] = { LanesSet(c.B[0]), LanesSet(c.B[1]), LanesSet(c.B[2]), LanesSet(c.A[1]), LanesSet(c.A[2]) };
+		}
+		FilterLanes RunMovingAverage(const FilterLanes& x) {
+			m_Sum = m_Sum + x - m_History[m_HistoryIndex];
+			m_History[m_HistoryIndex] = x;
+			const FilterLanes Ret = m_Sum * m_InvWindow;
+			if (++m_HistoryIndex == m_Window) { // 每轮重新求和，避免累积舍入误差
+				m_HistoryIndex = 0;
+				m_Sum = m_History[0];
+				for (uint32_t k = 1; k < m_Window; k++) {
+					m_Sum = m_Sum + m_History[k];
+				}
+			}
+			return Ret;
+		}
+		// 以第一个数据为稳态初始化各状态，避免从0开始的过渡过程
+		void Prime(const FilterLanes& x) {
+			const FilterLanes One = LanesSet(1.0f);
+			for (int s = 0; s < m_BiquadCount; s++) {
+				m_Z1[s] = (One - m_Biquads[s].Ff0) * x;
+				m_Z2[s] = (m_Biquads[s].Ff2 - m_Biquads[s].Fb2) * x;
+			}
+			for (uint32_t k = 0; k < m_Window; k++) {
+				m_History[k] = x;
+			}
+			m_Sum = x * LanesSet((float)m_Window);
+			m_HistoryIndex = 0;
+			m_Primed = true;
+		}
+		void UpdateTare(const float* x) {
+			if (m_TareRequest.load(std::memory_order_relaxed) != 0) { // 先读后交换，无请求时不做原子的读-改-写
+				const uint32_t Request = m_TareRequest.exchange(0, std::memory_order_acquire);
+				m_TareRemaining.store(Request, std::memory_order_release);
+				m_TareCount = Request;
+				for (int i = 0; i < DATA_COUNT; i++) {
+					m_TareSum[i] = 0.0;
+				}
+			}
+			uint32_t Remaining = m_TareRemaining.load(std::memory_order_relaxed);
+			if (Remaining == 0) {
+				return;
+			}
+			for (int i = 0; i < DATA_COUNT; i++) {
+				m_TareSum[i] += x[i];
+			}
+			m_TareRemaining.store(--Remaining, std::memory_order_release);
+			if (Remaining == 0) {
+				ForceSensorData Bias;
+				for (int i = 0; i < DATA_COUNT; i++) {
+					Bias[i] = (float)(m_TareSum[i] / m_TareCount);
+				}
+				SetBias(Bias);
+			}
+		}
+
+		FilterLanes m_Bias;                                // 零点
+		Biquad m_Biquads[FILTER_MAX_BIQUAD_COUNT];         // 低通的二阶节
+		FilterLanes m_Z1[FILTER_MAX_BIQUAD_COUNT];         // 二阶节状态
+		FilterLanes m_Z2[FILTER_MAX_BIQUAD_COUNT];
+		int m_BiquadCount = 0;
+		FilterLanes m_History[FILTER_MAX_WINDOW];          // 滑动平均窗口内的数据
+		FilterLanes m_Sum;                                 // 窗口内数据之和
+		FilterLanes m_InvWindow = LanesSet(1.0f);
+		uint32_t m_Window = 1;
+		uint32_t m_HistoryIndex = 0;
+		uint32_t m_Decimation = 1;
+		uint32_t m_DecimationCount = 0;
+		bool m_Primed = false;
+
+		std::atomic<uint32_t> m_TareRequest{ 0 };   // 其它线程请求的去皮数据个数
+		std::atomic<uint32_t> m_TareRemaining{ 0 }; // 本次去皮尚需的数据个数
+		uint32_t m_TareCount = 0;                   // 本次去皮的数据个数
+		double m_TareSum[DATA_COUNT] = {};          // 去皮数据之和
+		SeqLock<ForceSensorData> m_PublishedBias;   // 对外发布的零点
+	};
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace sia {
+	// 数据帧重组器
+	// 跨多次读取保留未完成的字节，按结束符切分数据帧，并按帧长度校验。
+	// 长度不符或超长的数据视为损坏并丢弃，在下一个结束符处自动重新同步，无需清空串口缓冲区。
+	template <size_t MaxFrameSize>
+	class FrameAssembler {
+	public:
+		static constexpr size_t MAX_FRAME_SIZE_COUNT = 4;
+
+		explicit FrameAssembler(char terminator = '\n') : m_Terminator(terminator) {}
+
+		// 设置帧格式，frameSizes为合法的帧长度（含结束符），为空表示不限长度
+		void SetFormat(char terminator, std::initializer_list<size_t> frameSizes) {
+			m_Terminator = terminator;
+			m_FrameSizeCount = 0;
+			for (size_t Size : frameSizes) {
+				if (m_FrameSizeCount < MAX_FRAME_SIZE_COUNT && Size > 0 && Size <= MaxFrameSize) {
+					m_FrameSizes[m_FrameSizeCount++] = Size;
+				}
+			}
+			Reset();
+		}
+
+		// 输入新读到的字节，每得到一个完整的帧调用一次onFrame(const char* frame, size_t size)，返回得到的帧数
+		template <typename OnFrame>
+		size_t Feed(const char* data, size_t count, OnFrame&& onFrame) {
+			size_t FrameCount = 0;
+			const char* End = data + count;
+			while (data < End) {
+				const char* Term = static_cast<const char*>(memchr(data, m_Terminator, End - data));
+				if (Term == nullptr) {
+					Append(data, End - data);
+					break;
+				}
+				const size_t SegmentSize = Term - data + 1;
+				if (m_Discarding) { // 上一段已损坏，丢弃至结束符
+					Increment(m_DiscardedBytes, SegmentSize);
+					m_Discarding = false;
+				}
+				else if (m_Size == 0) { // 没有残留字节，直接从输入中取帧
+					if (IsValidSize(SegmentSize)) {
+						onFrame(data, SegmentSize);
+						FrameCount++;
+					}
+					else {
+						Increment(m_DiscardedBytes, SegmentSize);
+					}
+				}
+				else if (IsValidSize(m_Size + SegmentSize)) { // 与上次残留的字节拼成一帧
+					memcpy(&m_Partial[m_Size], data, SegmentSize);
+					onFrame(&m_Partial[0], m_Size + SegmentSize);
+					FrameCount++;
+				}
+				else {
+					Increment(m_DiscardedBytes, m_Size + SegmentSize);
+				}
+				m_Size = 0;
+				data = Term + 1;
+			}
+			Increment(m_FrameCount, FrameCount);
+			return FrameCount;
+		}
+
+		// 丢弃残留的字节
+		void Reset() {
+			Increment(m_DiscardedBytes, m_Size);
+			m_Size = 0;
+			m_Discarding = false;
+		}
+
+		char Terminator() const {
+			return m_Terminator;
+		}
+		size_t PendingBytes() const {
+			return m_Size;
+		}
+		// 计数可在任意线程中读取
+		uint64_t FrameCount() const {
+			return m_FrameCount.load(std::memory_order_relaxed);
+		}
+		uint64_t DiscardedBytes() const {
+			return m_DiscardedBytes.load(std::memory_order_relaxed);
+		}
+
+	private:
+		// 只有读取线程写入，无需原子的读-改-写
+		static void Increment(std::atomic<uint64_t>& counter, uint64_t value) {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+		bool IsValidSize(size_t size) const {
+			if (m_FrameSizeCount == 0) {
+				return size <= MaxFrameSize;
+			}
+			for (size_t i = 0; i < m_FrameSizeCount; i++) {
+				if (m_FrameSizes[i] == size) {
+					return true;
+				}
+			}
+			return false;
+		}
+		void Append(const char* data, size_t count) {
+			if (m_Discarding) {
+				Increment(m_DiscardedBytes, count);
+				return;
+			}
+			if (m_Size + count > MaxFrameSize) { // 超过最大帧长仍未遇到结束符，丢弃至下一个结束符
+				Increment(m_DiscardedBytes, m_Size + count);
+				m_Size = 0;
+				m_Discarding = true;
+				return;
+			}
+			memcpy(&m_Partial[m_Size], data, count);
+			m_Size += count;
+		}
+
+	private:
+		char m_Terminator;
+		std::array<size_t, MAX_FRAME_SIZE_COUNT> m_FrameSizes = {};
+		size_t m_FrameSizeCount = 0;
+		std::array<char, MaxFrameSize> m_Partial = {}; // 未完成的帧
+		size_t m_Size = 0;                             // 未完成的帧的字节数
+		bool m_Discarding = false;                     // 是否正在丢弃损坏的数据
+		std::atomic<uint64_t> m_FrameCount{ 0 };
+		std::atomic<uint64_t> m_DiscardedBytes{ 0 };
+	};
+}
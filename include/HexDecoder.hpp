@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIA_HEX_SIMD // GCC/Clang x86平台按运行时检测的指令集选择SSSE3/AVX2实现，其它平台使用标量实现
+#endif
+
+namespace sia {
+	static constexpr int HEX_VALUE_COUNT = 6;                    // 每帧的数据个数
+	static constexpr int HEX_CHAR_COUNT = HEX_VALUE_COUNT * 4;   // 每帧的十六进制字符数
+	static constexpr int HEX_SCALE_COUNT = 8;                    // 比例系数数组长度，按SIMD宽度补齐
+
+	// 十六进制解码器实现
+	enum HexDecoderKind {
+		HEX_DECODER_AUTO = 0, // 运行时按CPU选择
+		HEX_DECODER_SCALAR,
+		HEX_DECODER_SSSE3,
+		HEX_DECODER_AVX2
+	};
+
+	// 解码函数：将24个十六进制字符（每4个字符一个16位数）解码为6个数，乘以对应的比例系数后写入out
+	// scale长度为HEX_SCALE_COUNT，含非法字符时返回false，此时out的内容不确定
+	using HexDecodeFunc = bool (*)(const char* hex, const float* scale, float* out);
+
+	inline int HexNibble(unsigned char c) {
+		if (c >= '0' && c <= '9') {
+			return c - '0';
+		}
+		c |= 0x20; // 转为小写
+		if (c >= 'a' && c <= 'f') {
+			return c - 'a' + 10;
+		}
+		return -1;
+	}
+
+	inline bool DecodeHexScalar(const char* hex, const float* scale, float* out) {
+		int Invalid = 0;
+		for (int i = 0; i < HEX_VALUE_COUNT; i++) {
+			int Value = 0;
+			for (int j = 0; j < 4; j++) {
+				int Nibble = HexNibble((unsigned char)hex[4 * i + j]);
+				Invalid |= Nibble;
+				Value = (Value << 4) | (Nibble & 0x0F);
+			}
+			out[i] = (float)Value * scale[i];
+		}
+		return Invalid >= 0;
+	}
+
+#ifdef SIA_HEX_SIMD
+	// 16个字符转为半字节，返回非法字符的位掩码（1表示非法）
+	__attribute__((target("ssse3")))
+	inline int HexNibbles128(__m128i chars, __m128i* pNibbles) {
+		const __m128i Lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+		const __m128i IsDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+		const __m128i IsAlpha = _mm_and_si128(_mm_cmpgt_epi8(Lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(Lower, _mm_set1_epi8('f' + 1)));
+		// '0'~'9'的低4位即为数值，'A'~'F'与'a'~'f'的低4位加9
+		*pNibbles = _mm_add_epi8(_mm_and_si128(chars, _mm_set1_epi8(0x0F)), _mm_and_si128(IsAlpha, _mm_set1_epi8(9)));
+		return ~_mm_movemask_epi8(_mm_or_si128(IsDigit, IsAlpha)) & 0xFFFF;
+	}
+	// 每4个半字节合并为一个32位数：先两两合并为字节，再两两合并为16位数
+	__attribute__((target("ssse3")))
+	inline __m128i HexCombine128(__m128i nibbles) {
+		const __m128i Bytes = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+		return _mm_madd_epi16(Bytes, _mm_set1_epi32(0x00010100));
+	}
+
+	__attribute__((target("ssse3")))
+	inline bool DecodeHexSsse3(const char* hex, const float* scale, float* out) {
+		__m128i Nibbles0, Nibbles1;
+		int Invalid = HexNibbles128(_mm_loadu_si128((const __m128i*)hex), &Nibbles0);
+		Invalid |= HexNibbles128(_mm_loadl_epi64((const __m128i*)(hex + 16)), &Nibbles1) & 0x00FF;
+		const __m128 Values0 = _mm_mul_ps(_mm_cvtepi32_ps(HexCombine128(Nibbles0)), _mm_loadu_ps(scale));
+		const __m128 Values1 = _mm_mul_ps(_mm_cvtepi32_ps(HexCombine128(Nibbles1)), _mm_loadu_ps(scale + 4));
+		_mm_storeu_ps(out, Values0);
+		_mm_storel_pi((__m64*)(out + 4), Values1);
+		return Invalid == 0;
+	}
+
+	__attribute__((target("avx2")))
+	inline bool DecodeHexAvx2(const char* hex, const float* scale, float* out) {
+		// 低128位为前16个字符，高128位的低8字节为后8个字符
+		const __m256i Chars = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)hex)),
+			_mm_loadl_epi64((const __m128i*)(hex + 16)), 1);
+		const __m256i Lower = _mm256_or_si256(Chars, _mm256_set1_epi8(0x20));
+		const __m256i IsDigit = _mm256_and_si256(_mm256_cmpgt_epi8(Chars, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), Chars));
+		const __m256i IsAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(Lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), Lower));
+		const uint32_t Valid = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(IsDigit, IsAlpha));
+		const __m256i Nibbles = _mm256_add_epi8(_mm256_and_si256(Chars, _mm256_set1_epi8(0x0F)), _mm256_and_si256(IsAlpha, _mm256_set1_epi8(9)));
+		const __m256i Bytes = _mm256_maddubs_epi16(Nibbles, _mm256_set1_epi16(0x0110));
+		const __m256i Words = _mm256_madd_epi16(Bytes, _mm256_set1_epi32(0x00010100));
+		const __m256 Values = _mm256_mul_ps(_mm256_cvtepi32_ps(Words), _mm256_loadu_ps(scale));
+		_mm256_maskstore_ps(out, _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0), Values);
+		return (Valid & 0x00FFFFFF) == 0x00FFFFFF;
+	}
+#endif // SIA_HEX_SIMD
+
+	// 返回指定实现的解码函数，CPU不支持时退回到可用的实现
+	inline HexDecodeFunc GetHexDecoder(HexDecoderKind kind = HEX_DECODER_AUTO) {
+#ifdef SIA_HEX_SIMD
+		__builtin_cpu_init();
+		const bool HasAvx2 = __builtin_cpu_supports("avx2");
+		const bool HasSsse3 = __builtin_cpu_supports("ssse3");
+		if ((kind == HEX_DECODER_AUTO || kind == HEX_DECODER_AVX2) && HasAvx2) {
+			return &DecodeHexAvx2;
+		}
+		if ((kind == HEX_DECODER_AUTO || kind == HEX_DECODER_AVX2 || kind == HEX_DECODER_SSSE3) && HasSsse3) {
+			return &DecodeHexSsse3;
+		}
+#else
+		(void)kind;
+#endif // SIA_HEX_SIMD
+		return &DecodeHexScalar;
+	}
+
+	// 当前使用的解码函数，首次调用时按CPU选择
+	inline std::atomic<HexDecodeFunc>& ActiveHexDecoder() {
+		static std::atomic<HexDecodeFunc> Decoder{ GetHexDecoder() };
+		return Decoder;
+	}
+	// 指定解码函数的实现，用于对比测试
+	inline void SetHexDecoder(HexDecoderKind kind) {
+		ActiveHexDecoder().store(GetHexDecoder(kind), std::memory_order_relaxed);
+	}
+	inline bool DecodeHex(const char* hex, const float* scale, float* out) {
+		return ActiveHexDecoder().load(std::memory_order_relaxed)(hex, scale, out);
+	}
+
+	// 解析[first, last)开头的十进制数（可带符号、小数点及指数，如"-32.800"、"1.5e3"），类似std::from_chars
+	// 不跳过空白、不依赖locale、不要求以'\0'结尾，成功时返回解析结束的位置，没有数字时返回nullptr
+	// 有效数字超过19位时多余的位被舍去，对灵敏度等短数值与atof结果一致
+	inline const char* ParseDecimal(const char* first, const char* last, float* value) {
+		static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 }; // 双精度可精确表示的10的幂
+		const char* p = first;
+		bool Negative = false;
+		if (p != last && (*p == '-' || *p == '+')) {
+			Negative = (*p == '-');
+			p++;
+		}
+		uint64_t Mantissa = 0;
+		int Digits = 0;   // 已计入Mantissa的有效数字数
+		int Exponent = 0; // 十进制指数
+		bool HasDigit = false;
+		for (; p != last && *p >= '0' && *p <= '9'; p++) {
+			HasDigit = true;
+			if (Digits < 19) {
+				Mantissa = Mantissa * 10 + (uint64_t)(*p - '0');
+				Digits += (Mantissa > 0) ? 1 : 0;
+			}
+			else {
+				Exponent++;
+			}
+		}
+		if (p != last && *p == '.') {
+			for (p++; p != last && *p >= '0' && *p <= '9'; p++) {
+				HasDigit = true;
+				if (Digits < 19) {
+					Mantissa = Mantissa * 10 + (uint64_t)(*p - '0');
+					Digits += (Mantissa > 0) ? 1 : 0;
+					Exponent--;
+				}
+			}
+		}
+		if (!HasDigit) {
+			return nullptr;
+		}
+		if (p != last && (*p == 'e' || *p == 'E')) { // 指数部分不完整时不解析，与from_chars一致
+			const char* q = p + 1;
+			bool ExpNegative = false;
+			if (q != last && (*q == '-' || *q == '+')) {
+				ExpNegative = (*q == '-');
+				q++;
+			}
+			if (q != last && *q >= '0' && *q <= '9') {
+				int Exp = 0;
+				for (; q != last && *q >= '0' && *q <= '9'; q++) {
+					Exp = (Exp < 10000) ? Exp * 10 + (*q - '0') : Exp;
+				}
+				Exponent += ExpNegative ? -Exp : Exp;
+				p = q;
+			}
+		}
+		double Result = (double)Mantissa;
+		if (Mantissa != 0) {
+			while (Exponent > 22 && Result < 1e300) {
+				Result *= 1e22;
+				Exponent -= 22;
+			}
+			while (Exponent < -22 && Result > 1e-300) {
+				Result /= 1e22;
+				Exponent += 22;
+			}
+			if (Exponent > 22) {
+				Result = HUGE_VAL;
+			}
+			else if (Exponent < -22) {
+				Result = 0.0;
+			}
+			else {
+				Result = (Exponent >= 0) ? Result * POW10[Exponent] : Result / POW10[-Exponent];
+			}
+		}
+		*value = (float)(Negative ? -Result : Result);
+		return p;
+	}
+}
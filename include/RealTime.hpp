@@ -0,0 +1,204 @@
+#pragma once
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <cerrno>
+#endif // WIN32
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace sia {
+	static constexpr size_t REALTIME_PREFAULT_STACK_SIZE = 256 * 1024; // 预先访问的栈大小，须小于线程栈大小
+	static constexpr size_t REALTIME_PAGE_SIZE = 4096;
+
+	// 实时线程配置，默认不做任何修改
+	struct RealTimeConfig {
+		int Cpu = -1;              // 绑定的CPU编号，-1表示不绑定
+		int Priority = 0;          // SCHED_FIFO优先级（1~99），0表示保持普通调度；Windows下大于0时使用TIME_CRITICAL优先级
+		bool LockMemory = false;   // 锁定进程的全部内存（mlockall），已映射的页面同时被预先调入，避免缺页
+		bool PrefaultStack = true; // 预先访问REALTIME_PREFAULT_STACK_SIZE字节的栈
+	};
+
+	// 将当前线程绑定到指定CPU
+	inline bool SetThreadAffinity(int cpu) {
+		if (cpu < 0) {
+			return true;
+		}
+#ifdef WIN32
+		return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#else
+		cpu_set_t CpuSet;
+		CPU_ZERO(&CpuSet);
+		CPU_SET(cpu, &CpuSet);
+		return pthread_setaffinity_np(pthread_self(), sizeof(CpuSet), &CpuSet) == 0;
+#endif // WIN32
+	}
+	// 设置当前线程为实时调度，通常需要root权限或CAP_SYS_NICE（或rtprio限制）
+	inline bool SetThreadRealTimePriority(int priority) {
+		if (priority <= 0) {
+			return true;
+		}
+#ifdef WIN32
+		return ::SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+		sched_param Param;
+		memset(&Param, 0, sizeof(Param));
+		Param.sched_priority = priority;
+		return pthread_setschedparam(pthread_self(), SCHED_FIFO, &Param) == 0;
+#endif // WIN32
+	}
+	// 锁定进程当前及之后映射的全部内存，通常需要root权限或CAP_IPC_LOCK（或memlock限制）
+	inline bool LockProcessMemory() {
+#ifdef WIN32
+		return true; // Windows下不支持，忽略
+#else
+		return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#endif // WIN32
+	}
+	// 逐页访问一段栈空间，使之后的函数调用不再因栈增长而缺页
+#if defined(_MSC_VER)
+	__declspec(noinline)
+#else
+	__attribute__((noinline))
+#endif // _MSC_VER
+	inline void PrefaultStack() {
+		volatile char Stack[REALTIME_PREFAULT_STACK_SIZE];
+		for (size_t i = 0; i < REALTIME_PREFAULT_STACK_SIZE; i += REALTIME_PAGE_SIZE) {
+			Stack[i] = 0;
+		}
+		(void)Stack[0]; // 读取一次，避免被优化掉
+	}
+
+	// 在当前线程中应用实时配置，全部成功时返回true
+	inline bool ApplyRealTimeConfig(const RealTimeConfig& cfg) {
+		if (cfg.LockMemory && !LockProcessMemory()) {
+			return false;
+		}
+		if (!SetThreadAffinity(cfg.Cpu) || !SetThreadRealTimePriority(cfg.Priority)) {
+			return false;
+		}
+		if (cfg.PrefaultStack) {
+			PrefaultStack();
+		}
+		return true;
+	}
+
+	// 周期调度的统计
+	struct RateSchedulerStats {
+		uint64_t Cycles;        // 已执行的周期数
+		uint64_t Overruns;      // 上一周期的工作超过截止时刻，本周期迟到开始的次数
+		uint64_t SkippedCycles; // 因超时而整个跳过的周期数
+		int64_t MaxLatenessNs;  // Wait返回时刻相对计划时刻的最大延迟
+	};
+
+	// 无漂移的固定周期调度器
+	// 以绝对时刻唤醒（Linux下为clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)），计划时刻为 起点 + k * 周期，
+	// 每个周期的工作耗时不会累积为漂移。超时时迟到开始，错过的整个周期被跳过，计划时刻仍保持在同一网格上。
+	// 可选在计划时刻前spin提前醒来，之后忙等到计划时刻，以减小唤醒延迟。Wait只在一个线程中调用，GetStats可在任意线程中调用。
+	class RateScheduler {
+	public:
+		explicit RateScheduler(std::chrono::nanoseconds period = std::chrono::milliseconds(1), std::chrono::nanoseconds spin = std::chrono::nanoseconds(0)) {
+			SetPeriod(period, spin);
+		}
+
+		// 设置周期及忙等时间，下一次Wait时以当前时刻重新开始
+		void SetPeriod(std::chrono::nanoseconds period, std::chrono::nanoseconds spin = std::chrono::nanoseconds(0)) {
+			m_PeriodNs = (period.count() > 0) ? period.count() : 1;
+			m_SpinNs = (spin.count() > 0) ? spin.count() : 0;
+			m_Started = false;
+		}
+		std::chrono::nanoseconds Period() const {
+			return std::chrono::nanoseconds(m_PeriodNs);
+		}
+		// 以当前时刻为起点，第一个周期立即开始
+		void Start() {
+			m_NextNs = NowNs();
+			m_Started = true;
+		}
+
+		// 等待到下一个周期的计划时刻，返回该计划时刻（单调时钟，纳秒）
+		int64_t Wait() {
+			if (!m_Started) {
+				Start();
+			}
+			int64_t Now = NowNs();
+			if (Now > m_NextNs) { // 上一周期的工作超时
+				const int64_t Missed = (Now - m_NextNs) / m_PeriodNs; // 完全错过的周期数
+				if (Missed > 0) {
+					m_NextNs += Missed * m_PeriodNs;
+					Increment(m_SkippedCycles, (uint64_t)Missed);
+				}
+				Increment(m_Overruns, 1);
+			}
+			else {
+				if (m_NextNs - Now > m_SpinNs) {
+					SleepUntil(m_NextNs - m_SpinNs);
+				}
+				while ((Now = NowNs()) < m_NextNs) {} // 忙等
+			}
+			const int64_t Lateness = Now - m_NextNs;
+			if (Lateness > m_MaxLatenessNs.load(std::memory_order_relaxed)) {
+				m_MaxLatenessNs.store(Lateness, std::memory_order_relaxed);
+			}
+			Increment(m_Cycles, 1);
+			const int64_t Scheduled = m_NextNs;
+			m_NextNs += m_PeriodNs;
+			return Scheduled;
+		}
+
+		RateSchedulerStats GetStats() const {
+			RateSchedulerStats Stats;
+			Stats.Cycles = m_Cycles.load(std::memory_order_relaxed);
+			Stats.Overruns = m_Overruns.load(std::memory_order_relaxed);
+			Stats.SkippedCycles = m_SkippedCycles.load(std::memory_order_relaxed);
+			Stats.MaxLatenessNs = m_MaxLatenessNs.load(std::memory_order_relaxed);
+			return Stats;
+		}
+		void ResetStats() {
+			m_Cycles.store(0, std::memory_order_relaxed);
+			m_Overruns.store(0, std::memory_order_relaxed);
+			m_SkippedCycles.store(0, std::memory_order_relaxed);
+			m_MaxLatenessNs.store(0, std::memory_order_relaxed);
+		}
+
+		// 单调时钟，纳秒，与MonotonicNs()相同
+		static int64_t NowNs() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+		// 睡眠到绝对时刻timeNs
+		static void SleepUntil(int64_t timeNs) {
+#ifdef WIN32
+			std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timeNs)));
+#else
+			timespec Time;
+			Time.tv_sec = (time_t)(timeNs / 1000000000);
+			Time.tv_nsec = (long)(timeNs % 1000000000);
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Time, nullptr) == EINTR) {}
+#endif // WIN32
+		}
+
+	private:
+		static void Increment(std::atomic<uint64_t>& counter, uint64_t value) {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		int64_t m_PeriodNs = 1;
+		int64_t m_SpinNs = 0;
+		int64_t m_NextNs = 0;   // 下一个周期的计划时刻
+		bool m_Started = false;
+		std::atomic<uint64_t> m_Cycles{ 0 };
+		std::atomic<uint64_t> m_Overruns{ 0 };
+		std::atomic<uint64_t> m_SkippedCycles{ 0 };
+		std::atomic<int64_t> m_MaxLatenessNs{ 0 };
+	};
+}
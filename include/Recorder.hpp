@@ -0,0 +1,492 @@
+#pragma once
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ForceSensor.hpp"
+#include "Transport.hpp"
+
+namespace sia {
+	static constexpr uint64_t RECORD_FILE_MAGIC = 0x3130434552414953ull; // "SIAREC01"
+	static constexpr uint32_t RECORD_FILE_VERSION = 1;
+	static constexpr size_t RECORD_SEGMENT_SIZE = 65536; // 默认每个段文件的记录数，约8MB
+	static constexpr size_t RECORD_PAGE_SIZE = 4096;     // 预先写入段文件时的步长
+
+	// 单条记录，固定128字节
+	struct ForceSensorRecord {
+		int64_t ReceiveTimeNs;    // 收到完整数据帧的时刻，纳秒
+		int64_t RequestTimeNs;    // 发送请求的时刻，纳秒，连续输出模式下为0
+		uint64_t Sequence;        // 序号，解析失败的帧为上一个有效采样的序号
+		ForceSensorData Data;     // 解析后的数据，仅Status为SAMPLE_VALID时有效
+		uint32_t Status;          // ForceSensorStatus
+		uint32_t Reserved0;
+		ForceSensorBuffer Buffer; // 原始数据帧，剩余部分补0
+		char Reserved1[12];
+	};
+	static_assert(sizeof(ForceSensorRecord) == 128, "ForceSensorRecord must be 128 bytes");
+
+	// 段文件头，64字节，其后紧跟Capacity条记录
+	struct RecordFileHeader {
+		uint64_t Magic;
+		uint32_t Version;
+		uint32_t RecordSize;
+		uint64_t Capacity;   // 可容纳的记录数
+		std::atomic<uint64_t> Count; // 已写入的记录数，记录写完后以release发布，读取时以acquire读取
+		int64_t FirstTimeNs; // 第一条记录的时刻
+		int64_t LastTimeNs;  // 最后一条记录的时刻
+		uint64_t Reserved[2];
+	};
+	static_assert(sizeof(RecordFileHeader) == 64, "RecordFileHeader must be 64 bytes");
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "record file header requires address-free atomics");
+
+	// 内存映射文件
+	class MappedFile {
+	public:
+		explicit MappedFile() {}
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		~MappedFile() { Close(); }
+
+		// 创建size字节的文件并以读写方式映射，已存在时覆盖。磁盘空间及页表均在此时分配
+		bool Create(const std::string& path, size_t size) {
+			Close();
+#ifdef WIN32
+			m_File = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (m_File == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+			m_Mapping = CreateFileMappingA(m_File, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+			if (m_Mapping == NULL) {
+				Close();
+				return false;
+			}
+			m_pData = (char*)MapViewOfFile(m_Mapping, FILE_MAP_WRITE, 0, 0, size);
+#else
+			m_Fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (m_Fd < 0) {
+				return false;
+			}
+			if (posix_fallocate(m_Fd, 0, (off_t)size) != 0) {
+				Close();
+				return false;
+			}
+			void* pData = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Fd, 0);
+			m_pData = (pData == MAP_FAILED) ? nullptr : (char*)pData;
+#endif // WIN32
+			if (m_pData == nullptr) {
+				Close();
+				return false;
+			}
+			m_Size = size;
+			return true;
+		}
+		// 以只读方式映射已存在的文件
+		bool OpenRead(const std::string& path) {
+			Close();
+#ifdef WIN32
+			m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			LARGE_INTEGER FileSize;
+			if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &FileSize) || FileSize.QuadPart == 0) {
+				Close();
+				return false;
+			}
+			m_Mapping = CreateFileMappingA(m_File, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (m_Mapping == NULL) {
+				Close();
+				return false;
+			}
+			m_pData = (char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+			m_Size = (size_t)FileSize.QuadPart;
+#else
+			m_Fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			struct stat Stat;
+			if (m_Fd < 0 || fstat(m_Fd, &Stat) != 0 || Stat.st_size == 0) {
+				Close();
+				return false;
+			}
+			void* pData = mmap(nullptr, (size_t)Stat.st_size, PROT_READ, MAP_SHARED, m_Fd, 0);
+			m_pData = (pData == MAP_FAILED) ? nullptr : (char*)pData;
+			m_Size = (size_t)Stat.st_size;
+#endif // WIN32
+			if (m_pData == nullptr) {
+				Close();
+				return false;
+			}
+			return true;
+		}
+		// 解除映射并关闭文件，truncateSize非0时将文件截断为该长度
+		void Close(size_t truncateSize = 0) {
+#ifdef WIN32
+			if (m_pData != nullptr) {
+				UnmapViewOfFile(m_pData);
+			}
+			if (m_Mapping != NULL) {
+				CloseHandle(m_Mapping);
+				m_Mapping = NULL;
+			}
+			if (m_File != INVALID_HANDLE_VALUE) {
+				if (truncateSize > 0) {
+					LARGE_INTEGER Position;
+					Position.QuadPart = (LONGLONG)truncateSize;
+					SetFilePointerEx(m_File, Position, NULL, FILE_BEGIN);
+					SetEndOfFile(m_File);
+				}
+				CloseHandle(m_File);
+				m_File = INVALID_HANDLE_VALUE;
+			}
+#else
+			if (m_pData != nullptr) {
+				munmap(m_pData, m_Size);
+			}
+			if (m_Fd >= 0) {
+				if (truncateSize > 0 && ftruncate(m_Fd, (off_t)truncateSize) != 0) {
+					// 截断失败时保留预分配的长度，读取时以文件头中的记录数为准
+				}
+				close(m_Fd);
+				m_Fd = -1;
+			}
+#endif // WIN32
+			m_pData = nullptr;
+			m_Size = 0;
+		}
+
+		char* Data() const {
+			return m_pData;
+		}
+		size_t Size() const {
+			return m_Size;
+		}
+
+	private:
+#ifdef WIN32
+		HANDLE m_File = INVALID_HANDLE_VALUE;
+		HANDLE m_Mapping = NULL;
+#else
+		int m_Fd = -1;
+#endif // WIN32
+		char* m_pData = nullptr;
+		size_t m_Size = 0;
+	};
+
+	// 第index个段文件的路径：basePath.000000.rec
+	inline std::string RecordSegmentPath(const std::string& basePath, size_t index) {
+		char Suffix[32];
+		snprintf(Suffix, sizeof(Suffix), ".%06u.rec", (unsigned)index);
+		return basePath + Suffix;
+	}
+
+	// 二进制记录器，将每个数据帧的时间戳、序号、原始字节及解析后的数据追加到预分配的内存映射文件中
+	// 写入只是一次内存拷贝，不调用系统调用。下一个段文件由辅助线程预先创建并预分配页，
+	// 当前段写满时写者只交换指针，旧段的解除映射、截断及关闭同样在辅助线程中进行。
+	// 作为ForceSensorSink使用时由传感器的读取线程写入，否则同一时刻只能有一个线程调用Append。
+	class ForceSensorRecorder : public ForceSensorSink {
+	public:
+		explicit ForceSensorRecorder(size_t recordsPerSegment = RECORD_SEGMENT_SIZE)
+			: m_RecordsPerSegment(recordsPerSegment > 0 ? recordsPerSegment : RECORD_SEGMENT_SIZE) {}
+		ForceSensorRecorder(const ForceSensorRecorder& other) = delete;
+		ForceSensorRecorder& operator=(const ForceSensorRecorder& other) = delete;
+		~ForceSensorRecorder() { Close(); }
+
+		// 开始记录，创建basePath.000000.rec，并在辅助线程中预先创建下一个段文件
+		bool Open(const std::string& basePath) {
+			Close();
+			m_BasePath = basePath;
+			m_SegmentCount = 0;
+			m_RecordCount = 0;
+			std::unique_ptr<MappedFile> pFile = CreateSegment(0);
+			if (pFile == nullptr) {
+				return false;
+			}
+			UseSegment(std::move(pFile));
+			m_PrepareFailed = false;
+			m_Stopping = false;
+			m_Helper = std::thread(&ForceSensorRecorder::HelperLoop, this);
+			return true;
+		}
+		// 结束记录，最后一个段文件截断为实际长度，删除预先创建而未使用的段文件
+		void Close() {
+			if (m_Helper.joinable()) {
+				{
+					std::lock_guard<std::mutex> Lock(m_Mutex);
+					m_Stopping = true;
+				}
+				m_Changed.notify_all();
+				m_Helper.join();
+			}
+			if (m_pFile != nullptr) {
+				CloseSegment(std::move(m_pFile), m_pHeader->Count.load(std::memory_order_relaxed));
+				m_pHeader = nullptr;
+				m_pRecords = nullptr;
+			}
+			if (m_pNextFile != nullptr) {
+				m_pNextFile->Close();
+				m_pNextFile.reset();
+				remove(RecordSegmentPath(m_BasePath, m_SegmentCount).c_str());
+			}
+		}
+		bool IsOpen() const {
+			return m_pHeader != nullptr;
+		}
+
+		// [写者] 追加一条记录
+		bool Append(const ForceSensorSample& sample, const ForceSensorBuffer& buffer) {
+			if (m_pHeader == nullptr) {
+				return false;
+			}
+			if (m_pHeader->Count.load(std::memory_order_relaxed) == m_pHeader->Capacity && !NextSegment()) {
+				return false;
+			}
+			const uint64_t Count = m_pHeader->Count.load(std::memory_order_relaxed);
+			ForceSensorRecord& Record = m_pRecords[Count];
+			Record.ReceiveTimeNs = sample.ReceiveTimeNs;
+			Record.RequestTimeNs = sample.RequestTimeNs;
+			Record.Sequence = sample.Sequence;
+			Record.Data = sample.Data;
+			Record.Status = (uint32_t)sample.Status;
+			Record.Buffer = buffer;
+			if (Count == 0) {
+				m_pHeader->FirstTimeNs = sample.ReceiveTimeNs;
+			}
+			m_pHeader->LastTimeNs = sample.ReceiveTimeNs;
+			m_pHeader->Count.store(Count + 1, std::memory_order_release); // 记录写完后再发布记录数，异常退出时不会读到写了一半的记录
+			m_RecordCount++;
+			return true;
+		}
+		void OnFrame(const ForceSensorSample& sample, const ForceSensorBuffer& buffer) override {
+			Append(sample, buffer);
+		}
+
+		uint64_t RecordCount() const {
+			return m_RecordCount;
+		}
+		size_t SegmentCount() const {
+			return m_SegmentCount;
+		}
+
+	private:
+		// 创建第index个段文件并写入文件头，磁盘空间及可写的页表均在此时分配，耗时数毫秒
+		std::unique_ptr<MappedFile> CreateSegment(size_t index) const {
+			std::unique_ptr<MappedFile> pFile = std::make_unique<MappedFile>();
+			if (!pFile->Create(RecordSegmentPath(m_BasePath, index), sizeof(RecordFileHeader) + m_RecordsPerSegment * sizeof(ForceSensorRecord))) {
+				return nullptr;
+			}
+			RecordFileHeader* pHeader = new (pFile->Data()) RecordFileHeader();
+			pHeader->Magic = RECORD_FILE_MAGIC;
+			pHeader->Version = RECORD_FILE_VERSION;
+			pHeader->RecordSize = (uint32_t)sizeof(ForceSensorRecord);
+			pHeader->Capacity = m_RecordsPerSegment;
+			pHeader->Count.store(0, std::memory_order_relaxed);
+			// MAP_POPULATE对共享映射只建立只读页表，首次写入每页仍会缺页，在此逐页写入一次
+			volatile char* pData = pFile->Data();
+			for (size_t Offset = sizeof(RecordFileHeader); Offset < pFile->Size(); Offset += RECORD_PAGE_SIZE) {
+				pData[Offset] = 0;
+			}
+			return pFile;
+		}
+		static void CloseSegment(std::unique_ptr<MappedFile> pFile, uint64_t count) {
+			pFile->Close(sizeof(RecordFileHeader) + (size_t)count * sizeof(ForceSensorRecord));
+		}
+		void UseSegment(std::unique_ptr<MappedFile> pFile) {
+			m_pFile = std::move(pFile);
+			m_pHeader = (RecordFileHeader*)m_pFile->Data();
+			m_pRecords = (ForceSensorRecord*)(m_pFile->Data() + sizeof(RecordFileHeader));
+			m_SegmentCount++;
+		}
+		// [写者] 当前段已满，换用预先创建的段，旧段交给辅助线程关闭。辅助线程来不及创建时等待其完成
+		bool NextSegment() {
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			m_Changed.wait(Lock, [this]() { return m_pNextFile != nullptr || m_PrepareFailed; });
+			if (m_pNextFile == nullptr) {
+				return false;
+			}
+			m_pClosingFile = std::move(m_pFile);
+			m_ClosingCount = m_pHeader->Count.load(std::memory_order_relaxed);
+			UseSegment(std::move(m_pNextFile));
+			Lock.unlock();
+			m_Changed.notify_all();
+			return true;
+		}
+		// [辅助线程] 关闭写满的段，并预先创建下一个段
+		void HelperLoop() {
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			while (true) {
+				m_Changed.wait(Lock, [this]() { return m_Stopping || m_pClosingFile != nullptr || (m_pNextFile == nullptr && !m_PrepareFailed); });
+				if (m_pClosingFile != nullptr) {
+					std::unique_ptr<MappedFile> pFile = std::move(m_pClosingFile);
+					const uint64_t Count = m_ClosingCount;
+					Lock.unlock();
+					CloseSegment(std::move(pFile), Count);
+					Lock.lock();
+				}
+				if (m_Stopping) {
+					return;
+				}
+				if (m_pNextFile == nullptr && !m_PrepareFailed) {
+					const size_t Index = m_SegmentCount; // 写者只在m_pNextFile非空时修改m_SegmentCount
+					Lock.unlock();
+					std::unique_ptr<MappedFile> pFile = CreateSegment(Index);
+					Lock.lock();
+					m_PrepareFailed = (pFile == nullptr);
+					m_pNextFile = std::move(pFile);
+					m_Changed.notify_all();
+				}
+			}
+		}
+
+		size_t m_RecordsPerSegment;
+		std::string m_BasePath;
+		std::unique_ptr<MappedFile> m_pFile; // 当前写入的段
+		RecordFileHeader* m_pHeader = nullptr;
+		ForceSensorRecord* m_pRecords = nullptr;
+		size_t m_SegmentCount = 0; // 已使用的段数，即下一个段的序号
+		uint64_t m_RecordCount = 0;
+
+		std::thread m_Helper;
+		std::mutex m_Mutex;
+		std::condition_variable m_Changed;
+		std::unique_ptr<MappedFile> m_pNextFile;    // 预先创建的下一个段
+		std::unique_ptr<MappedFile> m_pClosingFile; // 已写满、等待关闭的段
+		uint64_t m_ClosingCount = 0;
+		bool m_PrepareFailed = false;
+		bool m_Stopping = false;
+	};
+
+	// 记录读取器，映射全部段文件，可按序号遍历或按时刻定位
+	class ForceSensorRecordReader {
+	public:
+		explicit ForceSensorRecordReader() {}
+		ForceSensorRecordReader(const ForceSensorRecordReader& other) = delete;
+		ForceSensorRecordReader& operator=(const ForceSensorRecordReader& other) = delete;
+
+		// 打开basePath的所有段文件，遇到不存在或格式不符的段文件时停止
+		bool Open(const std::string& basePath) {
+			Close();
+			for (size_t i = 0;; i++) {
+				std::unique_ptr<MappedFile> pFile = std::make_unique<MappedFile>();
+				if (!pFile->OpenRead(RecordSegmentPath(basePath, i)) || pFile->Size() < sizeof(RecordFileHeader)) {
+					break;
+				}
+				const RecordFileHeader* pHeader = (const RecordFileHeader*)pFile->Data();
+				const uint64_t Count = pHeader->Count.load(std::memory_order_acquire); // 之前的记录均已写完
+				if (pHeader->Magic != RECORD_FILE_MAGIC || pHeader->Version != RECORD_FILE_VERSION
+					|| pHeader->RecordSize != sizeof(ForceSensorRecord)
+					|| pFile->Size() < sizeof(RecordFileHeader) + Count * sizeof(ForceSensorRecord)) {
+					break;
+				}
+				Segment Seg;
+				Seg.pRecords = (const ForceSensorRecord*)(pFile->Data() + sizeof(RecordFileHeader));
+				Seg.Start = m_Size;
+				Seg.Count = Count;
+				Seg.pFile = std::move(pFile);
+				m_Size += Seg.Count;
+				m_Segments.push_back(std::move(Seg));
+			}
+			return !m_Segments.empty();
+		}
+		void Close() {
+			m_Segments.clear();
+			m_Size = 0;
+			m_Position = 0;
+		}
+
+		// 总记录数
+		uint64_t Size() const {
+			return m_Size;
+		}
+		// 第index条记录，index须小于Size()
+		const ForceSensorRecord& At(uint64_t index) const {
+			size_t Low = 0;
+			size_t High = m_Segments.size() - 1;
+			while (Low < High) { // 找到最后一个Start <= index的段
+				size_t Mid = (Low + High + 1) / 2;
+				if (m_Segments[Mid].Start <= index) {
+					Low = Mid;
+				}
+				else {
+					High = Mid - 1;
+				}
+			}
+			return m_Segments[Low].pRecords[index - m_Segments[Low].Start];
+		}
+
+		// 定位到第index条记录
+		void Seek(uint64_t index) {
+			m_Position = (index < m_Size) ? index : m_Size;
+		}
+		// 定位到第一条收到时刻不早于timeNs的记录，返回其序号，没有时返回Size()
+		uint64_t SeekTime(int64_t timeNs) {
+			uint64_t Low = 0;
+			uint64_t High = m_Size;
+			while (Low < High) {
+				uint64_t Mid = Low + (High - Low) / 2;
+				if (At(Mid).ReceiveTimeNs < timeNs) {
+					Low = Mid + 1;
+				}
+				else {
+					High = Mid;
+				}
+			}
+			m_Position = Low;
+			return Low;
+		}
+		uint64_t Tell() const {
+			return m_Position;
+		}
+		// 读取当前记录并前进一条，已到末尾时返回false
+		bool Next(ForceSensorRecord* pRecord) {
+			if (m_Position >= m_Size) {
+				return false;
+			}
+			*pRecord = At(m_Position++);
+			return true;
+		}
+		// 按顺序对每条记录调用f
+		template <typename F>
+		void ForEach(F&& f) const {
+			for (const Segment& Seg : m_Segments) {
+				for (uint64_t i = 0; i < Seg.Count; i++) {
+					f(Seg.pRecords[i]);
+				}
+			}
+		}
+
+		// 将记录的原始数据帧按原来的时间间隔追加到回放传输层，用于重放整个解析流程
+		void LoadInto(ReplayTransport* pReplay) const {
+			if (m_Size == 0) {
+				return;
+			}
+			const int64_t StartNs = At(0).ReceiveTimeNs;
+			ForEach([pReplay, StartNs](const ForceSensorRecord& record) {
+				const void* pEnd = memchr(record.Buffer.data(), 0, BUFFER_MAX_SIZE);
+				const size_t Size = (pEnd == nullptr) ? BUFFER_MAX_SIZE : (size_t)((const char*)pEnd - record.Buffer.data());
+				pReplay->Append(record.ReceiveTimeNs - StartNs, record.Buffer.data(), Size);
+			});
+		}
+
+	private:
+		struct Segment {
+			std::unique_ptr<MappedFile> pFile;
+			const ForceSensorRecord* pRecords;
+			uint64_t Start; // 第一条记录的全局序号
+			uint64_t Count;
+		};
+
+		std::vector<Segment> m_Segments;
+		uint64_t m_Size = 0;
+		uint64_t m_Position = 0;
+	};
+}
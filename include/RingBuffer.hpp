@@ -0,0 +1,312 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace sia {
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	// 环形缓冲区中连续存放的一段元素，不拥有数据
+	template <typename T>
+	struct RingSpan {
+		const T* Data;
+		size_t Size;
+
+		const T* begin() const {
+			return Data;
+		}
+		const T* end() const {
+			return Data + Size;
+		}
+		bool Empty() const {
+			return Size == 0;
+		}
+		const T& operator[](size_t index) const {
+			return Data[index];
+		}
+	};
+
+	// 单生产者单消费者无锁环形缓冲区，容量N需为2的幂，存储空间在构造时一次性分配
+	template <typename T, size_t N>
+	class SpscRing {
+		static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of 2");
+
+	public:
+		SpscRing() : m_Head(0), m_Tail(0) {}
+		SpscRing(const SpscRing& other) = delete;
+		SpscRing& operator=(const SpscRing& other) = delete;
+
+		// [生产者] 写入一个元素，缓冲区满时丢弃该元素并返回false
+		bool Push(const T& item) {
+			const size_t Head = m_Head.load(std::memory_order_relaxed);
+			if (Head - m_Tail.load(std::memory_order_acquire) >= N) {
+				return false;
+			}
+			m_Slots[Head & MASK] = item;
+			m_Head.store(Head + 1, std::memory_order_release);
+			return true;
+		}
+
+		// [消费者] 按写入顺序取出一个元素
+		bool Pop(T* pItem) {
+			const size_t Tail = m_Tail.load(std::memory_order_relaxed);
+			if (Tail == m_Head.load(std::memory_order_acquire)) {
+				return false;
+			}
+			*pItem = m_Slots[Tail & MASK];
+			m_Tail.store(Tail + 1, std::memory_order_release);
+			return true;
+		}
+		// [消费者] 取出最新的元素，并丢弃比它旧的所有元素
+		bool PopLatest(T* pItem) {
+			const size_t Tail = m_Tail.load(std::memory_order_relaxed);
+			const size_t Head = m_Head.load(std::memory_order_acquire);
+			if (Tail == Head) {
+				return false;
+			}
+			*pItem = m_Slots[(Head - 1) & MASK];
+			m_Tail.store(Head, std::memory_order_release);
+			return true;
+		}
+
+		// [消费者] 按写入顺序取出最多maxCount个元素，返回取出的个数
+		size_t PopBatch(T* pItems, size_t maxCount) {
+			const size_t Tail = m_Tail.load(std::memory_order_relaxed);
+			const size_t Head = m_Head.load(std::memory_order_acquire);
+			const size_t Count = (Head - Tail < maxCount) ? Head - Tail : maxCount;
+			const size_t Begin = Tail & MASK;
+			const size_t First = (Count < N - Begin) ? Count : N - Begin; // 到缓冲区末尾为止的部分
+			for (size_t i = 0; i < First; i++) {
+				pItems[i] = m_Slots[Begin + i];
+			}
+			for (size_t i = First; i < Count; i++) {
+				pItems[i] = m_Slots[i - First];
+			}
+			m_Tail.store(Tail + Count, std::memory_order_release);
+			return Count;
+		}
+		// [消费者] 零拷贝读取：返回从最旧元素开始连续存放的可读元素，不取出
+		// 元素在调用Release之前不会被生产者覆盖；可读部分跨越缓冲区末尾时只返回末尾之前的部分
+		RingSpan<T> Peek() const {
+			const size_t Tail = m_Tail.load(std::memory_order_relaxed);
+			const size_t Head = m_Head.load(std::memory_order_acquire);
+			const size_t Begin = Tail & MASK;
+			const size_t Count = (Head - Tail < N - Begin) ? Head - Tail : N - Begin;
+			return { &m_Slots[Begin], Count };
+		}
+		// [消费者] 释放Peek得到的前count个元素
+		void Release(size_t count) {
+			m_Tail.store(m_Tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+		}
+
+		// [消费者] 清空缓冲区
+		void Clear() {
+			m_Tail.store(m_Head.load(std::memory_order_acquire), std::memory_order_release);
+		}
+
+		size_t Size() const {
+			return m_Head.load(std::memory_order_acquire) - m_Tail.load(std::memory_order_acquire);
+		}
+		bool Empty() const {
+			return Size() == 0;
+		}
+		static constexpr size_t Capacity() {
+			return N;
+		}
+
+	private:
+		static constexpr size_t MASK = N - 1;
+
+		// 生产者与消费者的下标分开放在不同的缓存行，避免伪共享
+		std::atomic<size_t> m_Head;
+		char m_HeadPad[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t> m_Tail;
+		char m_TailPad[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+		std::array<T, N> m_Slots;
+	};
+
+	template <typename T, size_t N>
+	class BroadcastReader;
+
+	// 单生产者多消费者广播环形缓冲区，容量N需为2的幂
+	// 生产者从不等待消费者：缓冲区满时覆盖最旧的元素。每个消费者（BroadcastReader）有独立的读取位置，
+	// 互不影响，可按不同的频率读取；被生产者超过一圈（lapped）时可检测到并跳到仍有效的最旧元素。
+	// 每个槽位带有序号，数据按8字节分块存放在原子变量中，读写重叠时不会产生数据竞争，消费者无需加锁。
+	template <typename T, size_t N>
+	class BroadcastRing {
+		static_assert(N >= 2 && (N & (N - 1)) == 0, "BroadcastRing capacity must be a power of 2");
+		static_assert(std::is_trivially_copyable<T>::value, "BroadcastRing requires a trivially copyable type");
+
+	public:
+		BroadcastRing() : m_Head(0) {
+			for (auto& Slot : m_Slots) {
+				Slot.Seq.store(0, std::memory_order_relaxed);
+			}
+		}
+		BroadcastRing(const BroadcastRing& other) = delete;
+		BroadcastRing& operator=(const BroadcastRing& other) = delete;
+
+		// [生产者] 写入一个元素，同一时刻只能有一个生产者
+		void Publish(const T& item) {
+			uint64_t Words[WORD_COUNT] = {};
+			memcpy(Words, &item, sizeof(T));
+			const uint64_t Position = m_Head.load(std::memory_order_relaxed);
+			Slot& Target = m_Slots[Position & MASK];
+			Target.Seq.store(Position * 2 + 1, std::memory_order_relaxed); // 奇数表示正在写入
+			std::atomic_thread_fence(std::memory_order_release);
+			for (size_t i = 0; i < WORD_COUNT; i++) {
+				Target.Words[i].store(Words[i], std::memory_order_relaxed);
+			}
+			Target.Seq.store(Position * 2 + 2, std::memory_order_release);
+			m_Head.store(Position + 1, std::memory_order_release);
+		}
+
+		// 读取最新的元素，任意线程均可调用，不影响各消费者的读取位置，尚未写入任何元素时返回false
+		bool ReadLatest(T* pItem) const {
+			while (true) {
+				const uint64_t Head = m_Head.load(std::memory_order_acquire);
+				if (Head == 0) {
+					return false;
+				}
+				if (Read(Head - 1, pItem) == READ_OK) {
+					return true;
+				}
+			}
+		}
+		// 已写入的元素总数，即下一个元素的位置
+		uint64_t Head() const {
+			return m_Head.load(std::memory_order_acquire);
+		}
+		static constexpr size_t Capacity() {
+			return N;
+		}
+
+	private:
+		friend class BroadcastReader<T, N>;
+
+		static constexpr size_t MASK = N - 1;
+		static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+		enum ReadResult {
+			READ_OK = 0,
+			READ_EMPTY,  // 该位置尚未写入
+			READ_LAPPED  // 该位置已被覆盖
+		};
+
+		struct Slot {
+			std::atomic<uint64_t> Seq; // 存放位置p的元素时为2p+2，正在写入时为2p+1
+			std::array<std::atomic<uint64_t>, WORD_COUNT> Words;
+		};
+
+		// 读取位置position的元素
+		ReadResult Read(uint64_t position, T* pItem) const {
+			const Slot& Source = m_Slots[position & MASK];
+			const uint64_t Expected = position * 2 + 2;
+			const uint64_t Seq = Source.Seq.load(std::memory_order_acquire);
+			if (Seq < Expected) {
+				return READ_EMPTY;
+			}
+			if (Seq > Expected) {
+				return READ_LAPPED;
+			}
+			uint64_t Words[WORD_COUNT];
+			for (size_t i = 0; i < WORD_COUNT; i++) {
+				Words[i] = Source.Words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Source.Seq.load(std::memory_order_relaxed) != Expected) { // 读取过程中被覆盖
+				return READ_LAPPED;
+			}
+			memcpy(pItem, Words, sizeof(T));
+			return READ_OK;
+		}
+
+		std::atomic<uint64_t> m_Head;
+		char m_HeadPad[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+		std::array<Slot, N> m_Slots;
+	};
+
+	// BroadcastRing的消费者，每个消费者线程使用自己的实例，不可在多个线程间共享
+	// 每次读取后位置前进decimation个元素（抽取），被超过一圈时跳到仍有效的最旧元素并累计丢失的元素数。
+	template <typename T, size_t N>
+	class BroadcastReader {
+	public:
+		// 默认从创建之后写入的元素开始读取
+		explicit BroadcastReader(const BroadcastRing<T, N>& ring, uint32_t decimation = 1)
+			: m_pRing(&ring), m_Cursor(ring.Head()), m_Decimation(decimation > 0 ? decimation : 1) {}
+
+		// 按写入顺序读取下一个元素（抽取后），没有新元素时返回false
+		bool Next(T* pItem) {
+			while (true) {
+				switch (m_pRing->Read(m_Cursor, pItem)) {
+				case BroadcastRing<T, N>::READ_OK:
+					m_Cursor += m_Decimation;
+					return true;
+				case BroadcastRing<T, N>::READ_EMPTY:
+					return false;
+				default:
+					Resync();
+					break;
+				}
+			}
+		}
+		// 读取最新的元素并跳过之前的所有元素，跳过的元素不计为丢失，没有新元素时返回false
+		bool Latest(T* pItem) {
+			while (true) {
+				const uint64_t Head = m_pRing->Head();
+				if (Head <= m_Cursor) {
+					return false;
+				}
+				if (m_pRing->Read(Head - 1, pItem) == BroadcastRing<T, N>::READ_OK) {
+					m_Cursor = Head - 1 + m_Decimation;
+					return true;
+				}
+			}
+		}
+		// 跳过所有已写入的元素
+		void SkipToHead() {
+			m_Cursor = m_pRing->Head();
+		}
+
+		// 尚未读取的元素数（未考虑抽取），大于容量时表示已被超过
+		uint64_t Pending() const {
+			const uint64_t Head = m_pRing->Head();
+			return (Head > m_Cursor) ? Head - m_Cursor : 0;
+		}
+		// 因被超过而丢失的元素数（未考虑抽取）
+		uint64_t LostCount() const {
+			return m_LostCount;
+		}
+		// 被超过的次数
+		uint64_t LapCount() const {
+			return m_LapCount;
+		}
+		void SetDecimation(uint32_t decimation) {
+			m_Decimation = (decimation > 0) ? decimation : 1;
+		}
+
+	private:
+		// 被超过后跳到仍有效的最旧元素，留出一段余量以免刚跳过去又被覆盖
+		void Resync() {
+			const uint64_t Head = m_pRing->Head();
+			const uint64_t Oldest = (Head > N - RESYNC_MARGIN) ? Head - (N - RESYNC_MARGIN) : 0;
+			if (Oldest > m_Cursor) {
+				m_LostCount += Oldest - m_Cursor;
+				m_Cursor = Oldest;
+			}
+			m_LapCount++;
+		}
+
+		static constexpr uint64_t RESYNC_MARGIN = (N >= 16) ? N / 8 : 1;
+
+		const BroadcastRing<T, N>* m_pRing;
+		uint64_t m_Cursor;       // 下一个要读取的位置
+		uint32_t m_Decimation;
+		uint64_t m_LostCount = 0;
+		uint64_t m_LapCount = 0;
+	};
+}
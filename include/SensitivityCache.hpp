@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include "ForceSensor.hpp"
+#include "HexDecoder.hpp"
+
+namespace sia {
+	// 灵敏度缓存，按 端口 + 传感器标识 保存各传感器的灵敏度，用于快速启动
+	// 文件为文本格式，每行一个传感器："端口\t标识\t6个以','分隔的灵敏度"，保存时先写临时文件再改名，中途断电不会损坏原文件。
+	// 可被多个传感器（含其后台校验线程）同时使用，所有接口均加锁。
+	class SensitivityCache {
+	public:
+		explicit SensitivityCache() {}
+		// 使用path作为缓存文件并读取，文件不存在时为空缓存
+		explicit SensitivityCache(const std::string& path) {
+			Load(path);
+		}
+		SensitivityCache(const SensitivityCache& other) = delete;
+		SensitivityCache& operator=(const SensitivityCache& other) = delete;
+
+		// 读取缓存文件并作为之后Store时保存的文件，格式错误的行被忽略，文件不存在时返回false
+		bool Load(const std::string& path) {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_Path = path;
+			m_Entries.clear();
+			FILE* pFile = fopen(path.c_str(), "rb");
+			if (pFile == nullptr) {
+				return false;
+			}
+			std::string Text;
+			char Chunk[4096];
+			size_t Size = 0;
+			while ((Size = fread(Chunk, 1, sizeof(Chunk), pFile)) > 0) {
+				Text.append(Chunk, Size);
+			}
+			fclose(pFile);
+			size_t Begin = 0;
+			while (Begin < Text.size()) {
+				size_t End = Text.find('\n', Begin);
+				if (End == std::string::npos) {
+					End = Text.size();
+				}
+				ParseLine(Text.data() + Begin, Text.data() + End);
+				Begin = End + 1;
+			}
+			return true;
+		}
+		// 查找缓存的灵敏度
+		bool Find(const std::string& port, const std::string& identity, ForceSensorData* pLsb) const {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			auto It = m_Entries.find(Key(port, identity));
+			if (It == m_Entries.end()) {
+				return false;
+			}
+			*pLsb = It->second;
+			return true;
+		}
+		// 更新灵敏度，与已缓存的值不同时写入缓存文件（若已指定）
+		bool Store(const std::string& port, const std::string& identity, const ForceSensorData& lsb) {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			ForceSensorData& Entry = m_Entries[Key(port, identity)];
+			if (Entry == lsb) {
+				return true;
+			}
+			Entry = lsb;
+			return m_Path.empty() || SaveLocked();
+		}
+		// 删除一个传感器的缓存
+		bool Erase(const std::string& port, const std::string& identity) {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			if (m_Entries.erase(Key(port, identity)) == 0) {
+				return true;
+			}
+			return m_Path.empty() || SaveLocked();
+		}
+		size_t Size() const {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			return m_Entries.size();
+		}
+
+	private:
+		static std::string Key(const std::string& port, const std::string& identity) {
+			return port + '\t' + identity;
+		}
+
+		void ParseLine(const char* first, const char* last) {
+			if (first != last && *(last - 1) == '\r') {
+				last--;
+			}
+			const char* Tab = first;
+			for (int Field = 0; Field < 2; Field++) { // 跳过端口及标识
+				while (Tab != last && *Tab != '\t') {
+					Tab++;
+				}
+				if (Tab == last) {
+					return;
+				}
+				Tab++;
+			}
+			ForceSensorData Lsb;
+			const char* p = Tab;
+			for (int i = 0; i < DATA_COUNT; i++) {
+				p = ParseDecimal(p, last, &Lsb[i]);
+				if (p == nullptr || !(Lsb[i] > 0.0f) || (i + 1 < DATA_COUNT && (p == last || *p++ != ','))) {
+					return;
+				}
+			}
+			m_Entries[std::string(first, Tab - 1)] = Lsb;
+		}
+
+		bool SaveLocked() const {
+			const std::string TempPath = m_Path + ".tmp";
+			FILE* pFile = fopen(TempPath.c_str(), "wb");
+			if (pFile == nullptr) {
+				return false;
+			}
+			bool Ret = true;
+			for (const auto& Entry : m_Entries) {
+				// 灵敏度以最短格式写入，不依赖locale（如de_DE下printf以','为小数点，与分隔符冲突）
+				char Text[DATA_TEXT_MAX_SIZE];
+				char* p = Text;
+				for (int i = 0; i < DATA_COUNT; i++) {
+					p = FormatShortest(p, Entry.second[i]);
+					*p++ = (i + 1 < DATA_COUNT) ? ',' : '\n';
+				}
+				Ret = Ret && fwrite(Entry.first.data(), 1, Entry.first.size(), pFile) == Entry.first.size()
+					&& fputc('\t', pFile) != EOF && fwrite(Text, 1, p - Text, pFile) == (size_t)(p - Text);
+			}
+			Ret = (fclose(pFile) == 0) && Ret;
+			if (!Ret) {
+				remove(TempPath.c_str());
+				return false;
+			}
+#ifdef WIN32
+			remove(m_Path.c_str()); // Windows下rename不覆盖已存在的文件
+#endif // WIN32
+			return rename(TempPath.c_str(), m_Path.c_str()) == 0;
+		}
+
+		mutable std::mutex m_Mutex;
+		std::string m_Path;                             // 缓存文件，空表示只在内存中缓存
+		std::map<std::string, ForceSensorData> m_Entries; // 端口\t标识 -> 灵敏度
+	};
+}
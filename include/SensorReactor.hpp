@@ -0,0 +1,172 @@
+#pragma once
+
+#ifndef WIN32
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+#include "ForceSensor.hpp"
+
+namespace sia {
+	// 多传感器事件循环，仅Linux
+	// 在单个线程中用epoll管理多个请求应答模式的传感器：每轮同时向所有传感器发送请求，
+	// 应答到达时重组并解析，更新各传感器的最新数据。每轮耗时取决于最慢的传感器，而不是所有传感器之和。
+	// 每个传感器同时只有一个请求：本轮超时的请求在下一轮继续等待而不重发，迟到的应答不会被当作新请求的应答；
+	// 连续超时MAX_MISSED_ROUNDS + 1轮后视为应答丢失，丢弃已到达的数据并重新请求。
+	class SensorReactor {
+	public:
+		// 单个传感器的统计信息
+		struct SensorStat {
+			uint64_t SampleCount = 0;  // 收到的有效数据帧数
+			uint64_t TimeoutCount = 0; // 本轮超时未应答的次数
+		};
+
+		explicit SensorReactor() : m_EpollFd(epoll_create1(EPOLL_CLOEXEC)) {}
+		SensorReactor(const SensorReactor& other) = delete;
+		SensorReactor& operator=(const SensorReactor& other) = delete;
+		~SensorReactor() {
+			Stop();
+			if (m_EpollFd >= 0) {
+				close(m_EpollFd);
+			}
+		}
+
+		// 添加已打开并初始化的传感器，返回其编号，失败返回-1。Start()之后不可再添加
+		int Add(ForceSensor* pSensor) {
+			if (m_EpollFd < 0 || m_Running || pSensor == nullptr || !pSensor->IsOpen()) {
+				return -1;
+			}
+			struct epoll_event Event = {};
+			Event.events = EPOLLIN;
+			Event.data.u64 = m_Entries.size();
+			if (epoll_ctl(m_EpollFd, EPOLL_CTL_ADD, pSensor->NativeHandle(), &Event) != 0) {
+				return -1;
+			}
+			m_Entries.emplace_back(pSensor);
+			m_Events.resize(m_Entries.size());
+			return (int)m_Entries.size() - 1;
+		}
+		size_t Size() const {
+			return m_Entries.size();
+		}
+
+		// 执行一轮：同时向所有没有未应答请求的传感器发送请求，等待全部应答或超时，返回本轮得到应答的传感器数
+		size_t PollOnce(const std::chrono::microseconds& timeout) {
+			size_t PendingCount = 0;
+			for (auto& Entry : m_Entries) {
+				if (Entry.Pending && ++Entry.MissedRounds > MAX_MISSED_ROUNDS) { // 应答丢失，丢弃不完整的数据后重新请求
+					Entry.pSensor->DiscardInput();
+					Entry.Pending = false;
+				}
+				if (!Entry.Pending) {
+					Entry.Pending = Entry.pSensor->SendCmd(REQUEST_SEND_DATA_ONCE);
+					Entry.MissedRounds = 0;
+				}
+				if (Entry.Pending) {
+					PendingCount++;
+				}
+			}
+			const size_t RequestCount = PendingCount;
+
+			const SerialTimePoint Deadline = SerialClock::now() + timeout;
+			while (PendingCount > 0) {
+				auto Remaining = std::chrono::duration_cast<std::chrono::microseconds>(Deadline - SerialClock::now()).count();
+				if (Remaining < 0) {
+					Remaining = 0;
+				}
+				int EventCount = epoll_wait(m_EpollFd, m_Events.data(), (int)m_Events.size(), (int)((Remaining + 999) / 1000));
+				if (EventCount < 0 && errno == EINTR) {
+					continue;
+				}
+				if (EventCount <= 0) { // 超时
+					break;
+				}
+				for (int i = 0; i < EventCount; i++) {
+					SensorEntry& Entry = m_Entries[m_Events[i].data.u64];
+					int FrameCount = Entry.pSensor->ProcessReadable();
+					Increment(Entry.SampleCount, (uint64_t)FrameCount);
+					if (FrameCount > 0 && Entry.Pending) {
+						Entry.Pending = false;
+						PendingCount--;
+					}
+				}
+			}
+
+			for (auto& Entry : m_Entries) {
+				if (Entry.Pending) { // 仍等待应答，下一轮不重发
+					Increment(Entry.TimeoutCount, 1);
+				}
+			}
+			return RequestCount - PendingCount;
+		}
+
+		// 在后台线程中连续执行PollOnce
+		bool Start(const std::chrono::microseconds& timeout = std::chrono::milliseconds(REPLY_TIMEOUT_MS)) {
+			if (m_Running || m_Entries.empty()) {
+				return false;
+			}
+			m_Running = true;
+			m_Thread = std::thread([this, timeout]() {
+				while (m_Running) {
+					PollOnce(timeout);
+					m_CycleCount++;
+				}
+			});
+			return true;
+		}
+		void Stop() {
+			m_Running = false;
+			if (m_Thread.joinable()) {
+				m_Thread.join();
+			}
+		}
+		uint64_t GetCycleCount() const {
+			return m_CycleCount;
+		}
+
+		// 获取第index个传感器的最新数据
+		ForceSensorData GetData(size_t index) const {
+			return m_Entries[index].pSensor->GetData();
+		}
+		ForceSensorSample GetSample(size_t index) const {
+			return m_Entries[index].pSensor->GetSample();
+		}
+		// 统计信息，可在任意线程中调用
+		SensorStat GetStat(size_t index) const {
+			SensorStat Stat;
+			Stat.SampleCount = m_Entries[index].SampleCount.load(std::memory_order_relaxed);
+			Stat.TimeoutCount = m_Entries[index].TimeoutCount.load(std::memory_order_relaxed);
+			return Stat;
+		}
+
+	private:
+		static constexpr uint32_t MAX_MISSED_ROUNDS = 1; // 请求超时后继续等待的轮数
+
+		struct SensorEntry {
+			explicit SensorEntry(ForceSensor* sensor) : pSensor(sensor) {}
+
+			ForceSensor* pSensor;
+			bool Pending = false;      // 是否有已发送而未应答的请求
+			uint32_t MissedRounds = 0; // 该请求已超时的轮数
+			std::atomic<uint64_t> SampleCount{ 0 };  // 仅事件循环线程写入
+			std::atomic<uint64_t> TimeoutCount{ 0 };
+		};
+
+		// 单写者计数，不需要原子的读-改-写
+		static void Increment(std::atomic<uint64_t>& counter, uint64_t value) {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		int m_EpollFd;
+		std::deque<SensorEntry> m_Entries; // 添加时不移动已有元素（含原子计数）
+		std::vector<struct epoll_event> m_Events;
+		std::atomic<bool> m_Running{ false };
+		std::atomic<uint64_t> m_CycleCount{ 0 };
+		std::thread m_Thread;
+	};
+}
+#endif // WIN32
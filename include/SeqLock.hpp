@@ -0,0 +1,90 @@
+#pragma once
+
+#ifdef WIN32
+#include <windows.h>
+#endif // WIN32
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace sia {
+	// 自旋等待时让出流水线
+	inline void CpuRelax() {
+#if defined(WIN32)
+		YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+	// 顺序锁，用于单写者向任意多个读者发布最新值
+	// 写者无锁且从不等待读者；读者不加锁，仅在与写入重叠时重读。
+	// 数据按8字节分块存放在原子变量中，读写重叠时不会产生数据竞争。
+	template <typename T>
+	class SeqLock {
+		static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+	public:
+		SeqLock() : m_Seq(0), m_Words{} {}
+		explicit SeqLock(const T& value) : SeqLock() {
+			Store(value);
+		}
+		SeqLock(const SeqLock& other) = delete;
+		SeqLock& operator=(const SeqLock& other) = delete;
+
+		// [写者] 发布新值，同一时刻只能有一个写者
+		void Store(const T& value) {
+			uint64_t Words[WORD_COUNT] = {};
+			memcpy(Words, &value, sizeof(T));
+			const uint64_t Seq = m_Seq.load(std::memory_order_relaxed);
+			m_Seq.store(Seq + 1, std::memory_order_relaxed); // 奇数表示正在写入
+			std::atomic_thread_fence(std::memory_order_release);
+			for (size_t i = 0; i < WORD_COUNT; i++) {
+				m_Words[i].store(Words[i], std::memory_order_relaxed);
+			}
+			m_Seq.store(Seq + 2, std::memory_order_release);
+		}
+
+		// [读者] 读取最新值，任意线程均可调用
+		T Load() const {
+			T Value;
+			while (!TryLoad(&Value)) {
+				CpuRelax();
+			}
+			return Value;
+		}
+		// [读者] 尝试读取一次，与写入重叠时返回false
+		bool TryLoad(T* pValue) const {
+			uint64_t Words[WORD_COUNT];
+			const uint64_t Seq = m_Seq.load(std::memory_order_acquire);
+			if (Seq & 1) {
+				return false;
+			}
+			for (size_t i = 0; i < WORD_COUNT; i++) {
+				Words[i] = m_Words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (m_Seq.load(std::memory_order_relaxed) != Seq) {
+				return false;
+			}
+			memcpy(pValue, Words, sizeof(T));
+			return true;
+		}
+
+		// 已发布的次数
+		uint64_t Version() const {
+			return m_Seq.load(std::memory_order_acquire) / 2;
+		}
+
+	private:
+		static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+		std::atomic<uint64_t> m_Seq;
+		std::array<std::atomic<uint64_t>, WORD_COUNT> m_Words;
+	};
+}
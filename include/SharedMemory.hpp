@@ -0,0 +1,445 @@
+#pragma once
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#endif // WIN32
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include "ForceSensor.hpp"
+#include "RingBuffer.hpp"
+
+namespace sia {
+	static constexpr uint64_t SHM_MAGIC = 0x31304D4853414953ull; // "SIASHM01"
+	static constexpr uint32_t SHM_VERSION = 1;
+	static constexpr size_t SHM_RING_SIZE = 4096; // 共享内存中缓存的最近采样个数
+	static constexpr size_t SHM_PAGE_SIZE = 4096;
+	static constexpr int SHM_POLL_INTERVAL_US = 100; // 客户端轮询等待新采样的间隔
+	using ShmSampleRing = BroadcastRing<ForceSensorSample, SHM_RING_SIZE>;
+	using ShmSampleReader = BroadcastReader<ForceSensorSample, SHM_RING_SIZE>;
+
+	static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "shared memory requires address-free atomics");
+
+	// 发布者状态
+	enum ShmState {
+		SHM_STATE_INITIALIZING = 0, // 正在初始化
+		SHM_STATE_ACTIVE,           // 正在发布
+		SHM_STATE_CLOSED            // 发布者已关闭
+	};
+
+	// 共享内存头，位于第一页。客户端按Magic、Version及各项大小检查布局是否一致
+	// 共享内存布局：头（一页）| ShmSampleRing（按页对齐）| ShmControl（一页，客户端可写）
+	struct ShmHeader {
+		uint64_t Magic;
+		uint32_t Version;
+		uint32_t HeaderSize;
+		uint32_t SampleSize;          // sizeof(ForceSensorSample)
+		uint32_t SlotCount;           // 环形缓冲区容量
+		uint64_t RingOffset;          // 环形缓冲区的偏移
+		uint64_t ControlOffset;       // 控制页的偏移
+		uint64_t TotalSize;           // 共享内存总大小
+		int64_t StartTimeNs;          // 发布者开始发布的时刻，单调时钟，纳秒
+		uint32_t ProducerPid;         // 发布者进程号
+		std::atomic<uint32_t> State;  // ShmState
+		std::atomic<uint32_t> WakeSeq; // 唤醒序号（futex），有客户端等待时每次发布加1
+	};
+
+	// 控制页，客户端以读写方式映射，仅用于登记等待者，数据区对客户端只读
+	struct ShmControl {
+		std::atomic<uint32_t> Waiters; // 正在等待新采样的客户端数
+	};
+
+	// 共享内存的布局
+	struct ShmLayout {
+		static constexpr size_t RingOffset() {
+			return SHM_PAGE_SIZE;
+		}
+		static constexpr size_t ControlOffset() {
+			return RingOffset() + (sizeof(ShmSampleRing) + SHM_PAGE_SIZE - 1) / SHM_PAGE_SIZE * SHM_PAGE_SIZE;
+		}
+		static constexpr size_t TotalSize() {
+			return ControlOffset() + SHM_PAGE_SIZE;
+		}
+	};
+	static_assert(sizeof(ShmHeader) <= SHM_PAGE_SIZE && sizeof(ShmControl) <= SHM_PAGE_SIZE, "shared memory header must fit in a page");
+
+#ifdef WIN32
+	// Windows下的命名映射对象名，去掉POSIX名称开头的'/'
+	inline std::string ShmMappingName(const std::string& name) {
+		return "Local\\" + ((!name.empty() && name[0] == '/') ? name.substr(1) : name);
+	}
+#else
+	// 跨进程的futex，不使用FUTEX_PRIVATE_FLAG
+	inline void ShmFutexWake(std::atomic<uint32_t>* pWord) {
+		syscall(SYS_futex, (uint32_t*)pWord, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+	}
+	// 当*pWord等于expected时等待，直到被唤醒或超时（相对时间）
+	inline void ShmFutexWait(std::atomic<uint32_t>* pWord, uint32_t expected, std::chrono::nanoseconds timeout) {
+		timespec Timeout;
+		Timeout.tv_sec = (time_t)(timeout.count() / 1000000000);
+		Timeout.tv_nsec = (long)(timeout.count() % 1000000000);
+		syscall(SYS_futex, (uint32_t*)pWord, FUTEX_WAIT, expected, &Timeout, nullptr, 0);
+	}
+#endif // WIN32
+
+	// 共享内存发布者，将有效采样写入POSIX共享内存（shm_open + mmap）中的广播环形缓冲区，供其他进程的ForceSensorShmClient读取
+	// 作为ForceSensorSink添加到ForceSensor（AddSink），也可直接调用Publish。只能有一个线程发布。
+	class ForceSensorShmPublisher : public ForceSensorSink {
+	public:
+		explicit ForceSensorShmPublisher() {}
+		ForceSensorShmPublisher(const ForceSensorShmPublisher& other) = delete;
+		ForceSensorShmPublisher& operator=(const ForceSensorShmPublisher& other) = delete;
+		~ForceSensorShmPublisher() { Close(); }
+
+		// 创建名为name的共享内存（如"/sia_force_sensor"），mode为访问权限，客户端需要读写权限才能阻塞等待
+		// 同名的共享内存已存在时，只在其发布者已关闭或进程已退出时删除并重新创建，否则返回false，
+		// 不会抢占存活的发布者；POSIX下此时errno为EEXIST
+		bool Open(const std::string& name, unsigned int mode = 0660) {
+			Close();
+			const size_t Size = ShmLayout::TotalSize();
+#ifdef WIN32
+			(void)mode;
+			m_Mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)Size >> 32), (DWORD)Size, ShmMappingName(name).c_str());
+			if (m_Mapping == NULL) {
+				return false;
+			}
+			if (GetLastError() == ERROR_ALREADY_EXISTS) { // 映射对象随最后一个句柄关闭而删除，已存在即仍在使用
+				CloseHandle(m_Mapping);
+				m_Mapping = NULL;
+				return false;
+			}
+			m_pData = (char*)MapViewOfFile(m_Mapping, FILE_MAP_WRITE, 0, 0, Size);
+#else
+			int Fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, (mode_t)mode);
+			if (Fd < 0 && errno == EEXIST) {
+				if (!IsStale(name)) { // 有存活的发布者或属于其他程序
+					errno = EEXIST;
+					return false;
+				}
+				shm_unlink(name.c_str()); // 只删除遗留的共享内存
+				Fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, (mode_t)mode);
+			}
+			if (Fd < 0) {
+				return false;
+			}
+			fchmod(Fd, (mode_t)mode); // 不受umask影响
+			void* pData = MAP_FAILED;
+			if (ftruncate(Fd, (off_t)Size) == 0) {
+				pData = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Fd, 0);
+			}
+			close(Fd);
+			if (pData == MAP_FAILED) {
+				shm_unlink(name.c_str());
+				return false;
+			}
+			m_pData = (char*)pData;
+#endif // WIN32
+			if (m_pData == nullptr) {
+				Close();
+				return false;
+			}
+			m_Name = name;
+			m_pHeader = new (m_pData) ShmHeader();
+#ifdef WIN32
+			m_pHeader->ProducerPid = (uint32_t)GetCurrentProcessId();
+#else
+			m_pHeader->ProducerPid = (uint32_t)getpid(); // 先于Magic写入，初始化中途退出时也能判断为遗留
+#endif // WIN32
+			m_pHeader->State.store(SHM_STATE_INITIALIZING, std::memory_order_relaxed);
+			m_pHeader->WakeSeq.store(0, std::memory_order_relaxed);
+			m_pHeader->Magic = SHM_MAGIC;
+			m_pHeader->Version = SHM_VERSION;
+			m_pHeader->HeaderSize = (uint32_t)sizeof(ShmHeader);
+			m_pHeader->SampleSize = (uint32_t)sizeof(ForceSensorSample);
+			m_pHeader->SlotCount = (uint32_t)SHM_RING_SIZE;
+			m_pHeader->RingOffset = ShmLayout::RingOffset();
+			m_pHeader->ControlOffset = ShmLayout::ControlOffset();
+			m_pHeader->TotalSize = Size;
+			m_pHeader->StartTimeNs = MonotonicNs();
+			m_pRing = new (m_pData + ShmLayout::RingOffset()) ShmSampleRing();
+			m_pControl = new (m_pData + ShmLayout::ControlOffset()) ShmControl();
+			m_pControl->Waiters.store(0, std::memory_order_relaxed);
+			m_pHeader->State.store(SHM_STATE_ACTIVE, std::memory_order_release);
+			return true;
+		}
+		// 标记为已关闭，唤醒等待中的客户端并删除共享内存，已连接的客户端仍可读取已发布的采样
+		void Close() {
+			if (m_pData == nullptr) {
+				return;
+			}
+			if (m_pHeader != nullptr) {
+				m_pHeader->State.store(SHM_STATE_CLOSED, std::memory_order_release);
+				Wake();
+			}
+#ifdef WIN32
+			UnmapViewOfFile(m_pData);
+			CloseHandle(m_Mapping);
+			m_Mapping = NULL;
+#else
+			munmap(m_pData, ShmLayout::TotalSize());
+			shm_unlink(m_Name.c_str());
+#endif // WIN32
+			m_pData = nullptr;
+			m_pHeader = nullptr;
+			m_pRing = nullptr;
+			m_pControl = nullptr;
+		}
+		bool IsOpen() const {
+			return m_pData != nullptr;
+		}
+
+		// 发布一个采样，没有客户端等待时不进入内核
+		void Publish(const ForceSensorSample& sample) {
+			if (m_pRing == nullptr) {
+				return;
+			}
+			m_pRing->Publish(sample);
+			std::atomic_thread_fence(std::memory_order_seq_cst); // 与客户端登记等待后的栅栏配对，避免丢失唤醒
+			if (m_pControl->Waiters.load(std::memory_order_relaxed) > 0) {
+				Wake();
+			}
+		}
+		// 只发布有效采样
+		void OnFrame(const ForceSensorSample& sample, const ForceSensorBuffer& buffer) override {
+			(void)buffer;
+			if (sample.Status == SAMPLE_VALID) {
+				Publish(sample);
+			}
+		}
+
+	private:
+#ifndef WIN32
+		// 名为name的共享内存是否为遗留的：由ForceSensorShmPublisher创建，且发布者已关闭或其进程已不存在
+		// 布局无法识别的共享内存可能属于其他程序，不视为遗留
+		static bool IsStale(const std::string& name) {
+			const int Fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+			if (Fd < 0) {
+				return errno == ENOENT; // 已被删除
+			}
+			struct stat Stat;
+			void* pData = MAP_FAILED;
+			if (fstat(Fd, &Stat) == 0 && (size_t)Stat.st_size >= sizeof(ShmHeader)) {
+				pData = mmap(nullptr, sizeof(ShmHeader), PROT_READ, MAP_SHARED, Fd, 0);
+			}
+			close(Fd);
+			if (pData == MAP_FAILED) {
+				return false;
+			}
+			const ShmHeader* pHeader = (const ShmHeader*)pData;
+			bool Stale = false;
+			if (pHeader->Magic == SHM_MAGIC && pHeader->ProducerPid != 0) {
+				Stale = pHeader->State.load(std::memory_order_acquire) == SHM_STATE_CLOSED
+					|| (kill((pid_t)pHeader->ProducerPid, 0) != 0 && errno == ESRCH);
+			}
+			munmap(pData, sizeof(ShmHeader));
+			return Stale;
+		}
+#endif // WIN32
+		void Wake() {
+			m_pHeader->WakeSeq.fetch_add(1, std::memory_order_release);
+#ifndef WIN32
+			ShmFutexWake(&m_pHeader->WakeSeq);
+#endif // WIN32
+		}
+
+		std::string m_Name;
+		char* m_pData = nullptr;
+		ShmHeader* m_pHeader = nullptr;
+		ShmSampleRing* m_pRing = nullptr;
+		ShmControl* m_pControl = nullptr;
+#ifdef WIN32
+		HANDLE m_Mapping = NULL;
+#endif // WIN32
+	};
+
+	// 共享内存客户端，只读映射发布者的数据区，读取时不进入内核
+	// 每个客户端有独立的读取位置，可抽取并检测被覆盖，语义同ForceSensorReader。只能在一个线程中使用。
+	class ForceSensorShmClient {
+	public:
+		explicit ForceSensorShmClient() {}
+		ForceSensorShmClient(const ForceSensorShmClient& other) = delete;
+		ForceSensorShmClient& operator=(const ForceSensorShmClient& other) = delete;
+		~ForceSensorShmClient() { Close(); }
+
+		// 连接名为name的共享内存，布局或版本不一致、发布者尚未初始化完成时返回false
+		// 没有写权限时仍可连接，但WaitNext退化为轮询
+		bool Open(const std::string& name, uint32_t decimation = 1) {
+			Close();
+			const size_t Size = ShmLayout::TotalSize();
+#ifdef WIN32
+			m_Mapping = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, ShmMappingName(name).c_str());
+			if (m_Mapping == NULL) {
+				return false;
+			}
+			m_pData = (const char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, Size);
+			if (m_pData == nullptr) {
+				Close();
+				return false;
+			}
+			m_pControlData = (char*)MapViewOfFile(m_Mapping, FILE_MAP_WRITE, 0, 0, Size);
+			if (m_pControlData != nullptr) {
+				m_pControl = (ShmControl*)(m_pControlData + ShmLayout::ControlOffset());
+			}
+#else
+			bool Writable = true;
+			int Fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+			if (Fd < 0) {
+				Writable = false;
+				Fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+			}
+			struct stat Stat;
+			if (Fd < 0 || fstat(Fd, &Stat) != 0 || (size_t)Stat.st_size != Size) {
+				if (Fd >= 0) {
+					close(Fd);
+				}
+				return false;
+			}
+			void* pData = mmap(nullptr, Size, PROT_READ, MAP_SHARED, Fd, 0);
+			if (pData != MAP_FAILED && Writable) {
+				void* pControl = mmap(nullptr, SHM_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, (off_t)ShmLayout::ControlOffset());
+				if (pControl != MAP_FAILED) {
+					m_pControlData = (char*)pControl;
+					m_pControl = (ShmControl*)pControl;
+				}
+			}
+			close(Fd);
+			if (pData == MAP_FAILED) {
+				Close();
+				return false;
+			}
+			m_pData = (const char*)pData;
+#endif // WIN32
+			m_pHeader = (const ShmHeader*)m_pData;
+			if (!CheckHeader(*m_pHeader)) {
+				Close();
+				return false;
+			}
+			m_pRing = (const ShmSampleRing*)(m_pData + ShmLayout::RingOffset());
+			m_pReader.reset(new ShmSampleReader(*m_pRing, decimation));
+			return true;
+		}
+		void Close() {
+			m_pReader.reset();
+#ifdef WIN32
+			if (m_pControlData != nullptr) {
+				UnmapViewOfFile(m_pControlData);
+			}
+			if (m_pData != nullptr) {
+				UnmapViewOfFile(m_pData);
+			}
+			if (m_Mapping != NULL) {
+				CloseHandle(m_Mapping);
+				m_Mapping = NULL;
+			}
+#else
+			if (m_pControlData != nullptr) {
+				munmap(m_pControlData, SHM_PAGE_SIZE);
+			}
+			if (m_pData != nullptr) {
+				munmap((void*)m_pData, ShmLayout::TotalSize());
+			}
+#endif // WIN32
+			m_pControlData = nullptr;
+			m_pControl = nullptr;
+			m_pData = nullptr;
+			m_pHeader = nullptr;
+			m_pRing = nullptr;
+		}
+		bool IsOpen() const {
+			return m_pData != nullptr;
+		}
+		// 发布者是否仍在发布
+		bool IsPublisherActive() const {
+			return m_pHeader != nullptr && m_pHeader->State.load(std::memory_order_acquire) == SHM_STATE_ACTIVE;
+		}
+		const ShmHeader* GetHeader() const {
+			return m_pHeader;
+		}
+
+		// 读取最新的采样，不影响读取位置
+		bool ReadLatest(ForceSensorSample* pSample) const {
+			return m_pRing != nullptr && m_pRing->ReadLatest(pSample);
+		}
+		// 按发布顺序读取下一个采样（抽取后），没有新采样时返回false
+		bool ReadNext(ForceSensorSample* pSample) {
+			return m_pReader && m_pReader->Next(pSample);
+		}
+		// 读取下一个采样，没有时等待直到有新采样、发布者关闭或超时
+		bool WaitNext(ForceSensorSample* pSample, std::chrono::nanoseconds timeout) {
+			if (ReadNext(pSample)) {
+				return true;
+			}
+			if (m_pReader == nullptr) {
+				return false;
+			}
+			const auto Deadline = std::chrono::steady_clock::now() + timeout;
+			if (m_pControl == nullptr) { // 不能登记等待，轮询
+				while (!ReadNext(pSample)) {
+					if (!IsPublisherActive() || std::chrono::steady_clock::now() >= Deadline) {
+						return false;
+					}
+					std::this_thread::sleep_for(std::chrono::microseconds(SHM_POLL_INTERVAL_US));
+				}
+				return true;
+			}
+			m_pControl->Waiters.fetch_add(1, std::memory_order_seq_cst);
+			bool Ret = false;
+			while (true) {
+				const uint32_t WakeSeq = m_pHeader->WakeSeq.load(std::memory_order_acquire);
+				if ((Ret = ReadNext(pSample)) || !IsPublisherActive()) {
+					break;
+				}
+				const auto Remaining = Deadline - std::chrono::steady_clock::now();
+				if (Remaining <= std::chrono::nanoseconds(0)) {
+					break;
+				}
+#ifdef WIN32
+				(void)WakeSeq;
+				std::this_thread::sleep_for(std::chrono::microseconds(SHM_POLL_INTERVAL_US));
+#else
+				ShmFutexWait((std::atomic<uint32_t>*)&m_pHeader->WakeSeq, WakeSeq, std::chrono::duration_cast<std::chrono::nanoseconds>(Remaining));
+#endif // WIN32
+			}
+			m_pControl->Waiters.fetch_sub(1, std::memory_order_relaxed);
+			return Ret;
+		}
+
+		// 因被超过而丢失的采样数
+		uint64_t LostCount() const {
+			return m_pReader ? m_pReader->LostCount() : 0;
+		}
+
+	private:
+		static bool CheckHeader(const ShmHeader& header) {
+			return header.Magic == SHM_MAGIC && header.Version == SHM_VERSION
+				&& header.HeaderSize == sizeof(ShmHeader) && header.SampleSize == sizeof(ForceSensorSample)
+				&& header.SlotCount == SHM_RING_SIZE && header.RingOffset == ShmLayout::RingOffset()
+				&& header.ControlOffset == ShmLayout::ControlOffset() && header.TotalSize == ShmLayout::TotalSize()
+				&& header.State.load(std::memory_order_acquire) != SHM_STATE_INITIALIZING;
+		}
+
+		const char* m_pData = nullptr;
+		char* m_pControlData = nullptr;
+		const ShmHeader* m_pHeader = nullptr;
+		const ShmSampleRing* m_pRing = nullptr;
+		ShmControl* m_pControl = nullptr;
+		std::unique_ptr<ShmSampleReader> m_pReader;
+#ifdef WIN32
+		HANDLE m_Mapping = NULL;
+#endif // WIN32
+	};
+}
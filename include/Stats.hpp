@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
+// 热路径统计开关，编译时定义SIA_STATS=0可完全去除统计代码及其开销
+#ifndef SIA_STATS
+#define SIA_STATS 1
+#endif // SIA_STATS
+
+namespace sia {
+	static constexpr int LATENCY_SUB_BUCKET_BITS = 4;                                // 每个2的幂区间分为16个子区间，相对误差不超过6.25%
+	static constexpr uint64_t LATENCY_SUB_BUCKET_COUNT = 1ull << LATENCY_SUB_BUCKET_BITS;
+	static constexpr int LATENCY_MAX_BITS = 36;                                      // 可记录的最大值约为2^36纳秒（68秒），超出部分计入最后一个区间
+	static constexpr size_t LATENCY_BUCKET_COUNT = (LATENCY_MAX_BITS - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKET_COUNT;
+
+	// 统计用的时间，单调时钟，纳秒
+	inline int64_t StatsNowNs() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// 数值对应的区间：小于16的值各占一个区间，之后每个2的幂区间线性分为16个子区间（HDR直方图的对数-线性分桶）
+	inline size_t LatencyBucketIndex(uint64_t value) {
+		if (value < LATENCY_SUB_BUCKET_COUNT) {
+			return (size_t)value;
+		}
+#ifdef _MSC_VER
+		unsigned long Msb;
+		_BitScanReverse64(&Msb, value);
+#else
+		const int Msb = 63 - __builtin_clzll(value);
+#endif // _MSC_VER
+		const int Shift = (int)Msb - LATENCY_SUB_BUCKET_BITS;
+		const size_t Index = (size_t)(Shift + 1) * LATENCY_SUB_BUCKET_COUNT + (size_t)((value >> Shift) - LATENCY_SUB_BUCKET_COUNT);
+		return (Index < LATENCY_BUCKET_COUNT) ? Index : LATENCY_BUCKET_COUNT - 1;
+	}
+	// 区间的下限
+	inline uint64_t LatencyBucketLowerBound(size_t index) {
+		if (index < LATENCY_SUB_BUCKET_COUNT) {
+			return index;
+		}
+		const size_t Shift = index / LATENCY_SUB_BUCKET_COUNT - 1;
+		return (LATENCY_SUB_BUCKET_COUNT + index % LATENCY_SUB_BUCKET_COUNT) << Shift;
+	}
+	// 区间的上限（包含）
+	inline uint64_t LatencyBucketUpperBound(size_t index) {
+		return (index + 1 < LATENCY_BUCKET_COUNT) ? LatencyBucketLowerBound(index + 1) - 1 : UINT64_MAX;
+	}
+
+	// 延迟直方图的快照，单位纳秒
+	struct LatencySnapshot {
+		std::array<uint64_t, LATENCY_BUCKET_COUNT> Buckets; // 各区间的个数
+		uint64_t Count;                                     // 总个数
+		uint64_t SumNs;                                     // 总和
+
+		double MeanNs() const {
+			return (Count > 0) ? (double)SumNs / (double)Count : 0.0;
+		}
+		// 第p百分位（0~100）所在区间的上限，无数据时返回0
+		uint64_t PercentileNs(double p) const {
+			if (Count == 0) {
+				return 0;
+			}
+			const uint64_t Target = (uint64_t)(p / 100.0 * (double)Count + 0.5);
+			uint64_t Sum = 0;
+			for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+				Sum += Buckets[i];
+				if (Sum >= Target && Buckets[i] > 0) {
+					return LatencyBucketUpperBound(i);
+				}
+			}
+			return MaxNs();
+		}
+		// 最大值所在区间的上限
+		uint64_t MaxNs() const {
+			for (size_t i = LATENCY_BUCKET_COUNT; i > 0; i--) {
+				if (Buckets[i - 1] > 0) {
+					return LatencyBucketUpperBound(i - 1);
+				}
+			}
+			return 0;
+		}
+	};
+
+	// 无锁延迟直方图，单写者，任意线程可读取快照
+	// 写者只做普通的原子读写，不使用读-改-写指令；快照为各区间的近似一致的拷贝。
+	class LatencyHistogram {
+	public:
+		LatencyHistogram() {
+			for (auto& Bucket : m_Buckets) {
+				Bucket.store(0, std::memory_order_relaxed);
+			}
+		}
+		LatencyHistogram(const LatencyHistogram& other) = delete;
+		LatencyHistogram& operator=(const LatencyHistogram& other) = delete;
+
+		// [写者] 记录一个值
+		void Record(int64_t valueNs) {
+			const uint64_t Value = (valueNs > 0) ? (uint64_t)valueNs : 0;
+			Increment(m_Buckets[LatencyBucketIndex(Value)], 1);
+			Increment(m_Count, 1);
+			Increment(m_Sum, Value);
+		}
+		void Snapshot(LatencySnapshot* pSnapshot) const {
+			for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+				pSnapshot->Buckets[i] = m_Buckets[i].load(std::memory_order_relaxed);
+			}
+			pSnapshot->Count = m_Count.load(std::memory_order_relaxed);
+			pSnapshot->SumNs = m_Sum.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static void Increment(std::atomic<uint64_t>& counter, uint64_t value) {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		std::array<std::atomic<uint64_t>, LATENCY_BUCKET_COUNT> m_Buckets;
+		std::atomic<uint64_t> m_Count{ 0 };
+		std::atomic<uint64_t> m_Sum{ 0 };
+	};
+
+	// 被统计的环节
+	enum ForceSensorTimer {
+		TIMER_SEND = 0,   // 发送指令（write）
+		TIMER_REPLY_WAIT, // 发送完成到读到应答的第一批数据（含首次read）
+		TIMER_READ,       // 之后补齐数据帧的每次读取
+		TIMER_PARSE,      // 解析一帧数据（ParseData）
+		TIMER_FLUSH,      // 清空缓冲区（tcflush/PurgeComm）
+		TIMER_SAMPLE,     // 一次请求应答读取的总耗时，含重试
+		TIMER_COUNT
+	};
+
+	// 统计计数
+	struct ForceSensorStatCounters {
+		uint64_t Retries;        // 请求应答读取的重试次数
+		uint64_t FrameRejects;   // 解析失败的数据帧数
+		uint64_t Timeouts;       // 等待应答超时次数
+		uint64_t ShortReads;     // 读到数据但未能组成完整帧的读取次数
+		uint64_t FlushedBytes;   // 清空缓冲区时丢弃的字节数
+		uint64_t DiscardedBytes; // 重组数据帧时丢弃的损坏字节数
+	};
+
+	// 统计快照，GetStats()的返回值
+	struct ForceSensorStats {
+		std::array<LatencySnapshot, TIMER_COUNT> Latency; // 按ForceSensorTimer索引
+		ForceSensorStatCounters Counters;
+	};
+
+	// 传感器的统计数据，单写者（读取线程）
+	// 重置不修改写者的数据，而是保存当前快照作为基准，之后的快照减去基准，因此写者始终无锁。
+	// 重试、解析失败、超时及丢弃字节数沿用ForceSensor已有的计数器，由调用者在快照时传入。
+	class ForceSensorStatsRecorder {
+	public:
+		ForceSensorStatsRecorder() : m_pBaseline(new ForceSensorStats()) {}
+
+		// [写者] 记录从startNs到现在的耗时
+		void Record(ForceSensorTimer timer, int64_t startNs) {
+			m_Latency[timer].Record(StatsNowNs() - startNs);
+		}
+		// [写者] 计数
+		void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		// [任意线程] 自上次重置以来的统计
+		ForceSensorStats Snapshot(const ForceSensorStatCounters& counters) const {
+			ForceSensorStats Stats;
+			Raw(&Stats, counters);
+			std::lock_guard<std::mutex> Lock(m_BaselineMutex);
+			const ForceSensorStats& Base = *m_pBaseline;
+			for (int t = 0; t < TIMER_COUNT; t++) {
+				LatencySnapshot& Latency = Stats.Latency[t];
+				for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+					Latency.Buckets[i] -= Base.Latency[t].Buckets[i];
+				}
+				Latency.Count -= Base.Latency[t].Count;
+				Latency.SumNs -= Base.Latency[t].SumNs;
+			}
+			Stats.Counters.Retries -= Base.Counters.Retries;
+			Stats.Counters.FrameRejects -= Base.Counters.FrameRejects;
+			Stats.Counters.Timeouts -= Base.Counters.Timeouts;
+			Stats.Counters.ShortReads -= Base.Counters.ShortReads;
+			Stats.Counters.FlushedBytes -= Base.Counters.FlushedBytes;
+			Stats.Counters.DiscardedBytes -= Base.Counters.DiscardedBytes;
+			return Stats;
+		}
+		// [任意线程] 重置
+		void Reset(const ForceSensorStatCounters& counters) {
+			std::lock_guard<std::mutex> Lock(m_BaselineMutex);
+			Raw(m_pBaseline.get(), counters);
+		}
+
+		std::atomic<uint64_t> ShortReads{ 0 };
+		std::atomic<uint64_t> FlushedBytes{ 0 };
+
+	private:
+		void Raw(ForceSensorStats* pStats, const ForceSensorStatCounters& counters) const {
+			for (int t = 0; t < TIMER_COUNT; t++) {
+				m_Latency[t].Snapshot(&pStats->Latency[t]);
+			}
+			pStats->Counters = counters;
+			pStats->Counters.ShortReads = ShortReads.load(std::memory_order_relaxed);
+			pStats->Counters.FlushedBytes = FlushedBytes.load(std::memory_order_relaxed);
+		}
+
+		std::array<LatencyHistogram, TIMER_COUNT> m_Latency;
+		mutable std::mutex m_BaselineMutex;
+		std::unique_ptr<ForceSensorStats> m_pBaseline; // 重置时的快照
+	};
+}
+
+// 统计宏，SIA_STATS为0时展开为空，参数不会被求值
+#if SIA_STATS
+#define SIA_STATS_START(var) const int64_t var = ::sia::StatsNowNs()        // 开始计时
+#define SIA_STATS_RECORD(stats, timer, start) (stats).Record(timer, start)  // 记录从start到现在的耗时
+#define SIA_STATS_ADD(stats, counter, value) (stats).Add((stats).counter, value)
+#else
+#define SIA_STATS_START(var) ((void)0)
+#define SIA_STATS_RECORD(stats, timer, start) ((void)0)
+#define SIA_STATS_ADD(stats, counter, value) ((void)0)
+#endif // SIA_STATS
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace sia {
+	static constexpr int TEXT_MAX_PRECISION = 9;       // 快速路径支持的最大小数位数
+	static constexpr size_t TEXT_NUMBER_MAX_SIZE = 64; // 单个数格式化后的最大长度
+
+	// 以下格式化函数类似std::to_chars：写入out并返回写入结束的位置，不写'\0'，不依赖locale，不分配内存
+	// out须至少有TEXT_NUMBER_MAX_SIZE字节
+
+	inline char* FormatUInt(char* out, uint64_t value) {
+		char Digits[20];
+		int Count = 0;
+		do {
+			Digits[Count++] = (char)('0' + value % 10);
+			value /= 10;
+		} while (value > 0);
+		while (Count > 0) {
+			*out++ = Digits[--Count];
+		}
+		return out;
+	}
+	inline char* FormatInt(char* out, int64_t value) {
+		if (value < 0) {
+			*out++ = '-';
+			return FormatUInt(out, 0 - (uint64_t)value);
+		}
+		return FormatUInt(out, (uint64_t)value);
+	}
+
+	// 慢速路径使用的定长无符号大整数，以2^32为基，容量足以精确表示单精度数与10的幂的乘积
+	class TextBigInt {
+	public:
+		static constexpr int MAX_LIMB_COUNT = 12;
+
+		explicit TextBigInt(uint64_t value = 0) {
+			m_Limbs[0] = (uint32_t)value;
+			m_Limbs[1] = (uint32_t)(value >> 32);
+			m_Count = (m_Limbs[1] != 0) ? 2 : ((m_Limbs[0] != 0) ? 1 : 0);
+		}
+
+		bool IsZero() const {
+			return m_Count == 0;
+		}
+		bool IsOdd() const {
+			return m_Count > 0 && (m_Limbs[0] & 1) != 0;
+		}
+		void MulSmall(uint32_t factor) {
+			uint64_t Carry = 0;
+			for (int i = 0; i < m_Count; i++) {
+				const uint64_t Product = (uint64_t)m_Limbs[i] * factor + Carry;
+				m_Limbs[i] = (uint32_t)Product;
+				Carry = Product >> 32;
+			}
+			if (Carry != 0) {
+				m_Limbs[m_Count++] = (uint32_t)Carry;
+			}
+		}
+		void MulPow10(int exponent) {
+			static const uint32_t POW10[9] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+			for (; exponent >= 9; exponent -= 9) {
+				MulSmall(1000000000);
+			}
+			if (exponent > 0) {
+				MulSmall(POW10[exponent]);
+			}
+		}
+		void ShiftLeft(int bits) {
+			if (m_Count == 0) {
+				return;
+			}
+			const int LimbShift = bits / 32;
+			const int BitShift = bits % 32;
+			m_Limbs[m_Count + LimbShift] = 0;
+			for (int i = m_Count - 1; i >= 0; i--) {
+				const uint64_t Shifted = (uint64_t)m_Limbs[i] << BitShift;
+				m_Limbs[i + LimbShift + 1] |= (uint32_t)(Shifted >> 32);
+				m_Limbs[i + LimbShift] = (uint32_t)Shifted;
+			}
+			for (int i = 0; i < LimbShift; i++) {
+				m_Limbs[i] = 0;
+			}
+			m_Count += LimbShift + 1;
+			Trim();
+		}
+		void ShiftRight(int bits) {
+			const int LimbShift = bits / 32;
+			const int BitShift = bits % 32;
+			if (LimbShift >= m_Count) {
+				m_Count = 0;
+				return;
+			}
+			for (int i = 0; i + LimbShift < m_Count; i++) {
+				uint64_t Pair = m_Limbs[i + LimbShift];
+				if (i + LimbShift + 1 < m_Count) {
+					Pair |= (uint64_t)m_Limbs[i + LimbShift + 1] << 32;
+				}
+				m_Limbs[i] = (uint32_t)(Pair >> BitShift);
+			}
+			m_Count -= LimbShift;
+			Trim();
+		}
+		void Add(const TextBigInt& other) {
+			const int Count = (m_Count > other.m_Count) ? m_Count : other.m_Count;
+			uint64_t Carry = 0;
+			for (int i = 0; i < Count; i++) {
+				const uint64_t Sum = (uint64_t)Limb(i) + other.Limb(i) + Carry;
+				m_Limbs[i] = (uint32_t)Sum;
+				Carry = Sum >> 32;
+			}
+			m_Count = Count;
+			if (Carry != 0) {
+				m_Limbs[m_Count++] = (uint32_t)Carry;
+			}
+		}
+		// 要求*this >= other
+		void Sub(const TextBigInt& other) {
+			int64_t Borrow = 0;
+			for (int i = 0; i < m_Count; i++) {
+				const int64_t Diff = (int64_t)m_Limbs[i] - other.Limb(i) - Borrow;
+				m_Limbs[i] = (uint32_t)Diff;
+				Borrow = (Diff < 0) ? 1 : 0;
+			}
+			Trim();
+		}
+		// 除以divisor，返回余数
+		uint32_t DivSmall(uint32_t divisor) {
+			uint64_t Remainder = 0;
+			for (int i = m_Count - 1; i >= 0; i--) {
+				const uint64_t Dividend = (Remainder << 32) | m_Limbs[i];
+				m_Limbs[i] = (uint32_t)(Dividend / divisor);
+				Remainder = Dividend % divisor;
+			}
+			Trim();
+			return (uint32_t)Remainder;
+		}
+		// 商很小时（如一位十进制数字）用减法求*this / divisor，*this变为余数
+		uint32_t DivSmallQuotient(const TextBigInt& divisor) {
+			uint32_t Quotient = 0;
+			while (Compare(*this, divisor) >= 0) {
+				Sub(divisor);
+				Quotient++;
+			}
+			return Quotient;
+		}
+		static int Compare(const TextBigInt& a, const TextBigInt& b) {
+			if (a.m_Count != b.m_Count) {
+				return (a.m_Count < b.m_Count) ? -1 : 1;
+			}
+			for (int i = a.m_Count - 1; i >= 0; i--) {
+				if (a.m_Limbs[i] != b.m_Limbs[i]) {
+					return (a.m_Limbs[i] < b.m_Limbs[i]) ? -1 : 1;
+				}
+			}
+			return 0;
+		}
+
+	private:
+		uint32_t Limb(int index) const {
+			return (index < m_Count) ? m_Limbs[index] : 0;
+		}
+		void Trim() {
+			while (m_Count > 0 && m_Limbs[m_Count - 1] == 0) {
+				m_Count--;
+			}
+		}
+
+		uint32_t m_Limbs[MAX_LIMB_COUNT + 1] = {};
+		int m_Count = 0;
+	};
+
+	// NaN及无穷大的格式与printf相同
+	inline char* FormatNonFinite(char* out, float value) {
+		const char* Text = std::isnan(value) ? "nan" : "inf";
+		if (std::signbit(value)) {
+			*out++ = '-';
+		}
+		memcpy(out, Text, 3);
+		return out + 3;
+	}
+	// 将有限的单精度数的绝对值精确分解为mantissa * 2^exponent，返回指数域（非规格化数为0）
+	inline int DecomposeFloat(float value, uint32_t* pMantissa, int* pExponent) {
+		uint32_t Bits;
+		memcpy(&Bits, &value, sizeof(Bits));
+		const int Biased = (int)((Bits >> 23) & 0xFF);
+		const uint32_t Fraction = Bits & 0x7FFFFF;
+		*pMantissa = (Biased == 0) ? Fraction : (Fraction | 0x800000);
+		*pExponent = ((Biased == 0) ? 1 : Biased) - 150;
+		return Biased;
+	}
+
+	// 定点格式的慢速路径：精确计算value * 10^precision并按就近偶数取整，结果与默认舍入模式下的printf相同
+	inline char* FormatFixedExact(char* out, float value, int precision) {
+		uint32_t Mantissa;
+		int Exponent;
+		DecomposeFloat(value, &Mantissa, &Exponent);
+		TextBigInt Scaled(Mantissa);
+		Scaled.MulPow10(precision);
+		if (Exponent >= 0) {
+			Scaled.ShiftLeft(Exponent);
+		}
+		else {
+			TextBigInt Remainder = Scaled;
+			Scaled.ShiftRight(-Exponent);
+			TextBigInt Truncated = Scaled;
+			Truncated.ShiftLeft(-Exponent);
+			Remainder.Sub(Truncated);
+			TextBigInt Half(1);
+			Half.ShiftLeft(-Exponent - 1);
+			const int Cmp = TextBigInt::Compare(Remainder, Half);
+			if (Cmp > 0 || (Cmp == 0 && Scaled.IsOdd())) {
+				Scaled.Add(TextBigInt(1));
+			}
+		}
+		char Digits[TEXT_NUMBER_MAX_SIZE];
+		int Count = 0;
+		do {
+			uint32_t Chunk = Scaled.DivSmall(1000000000);
+			for (int i = 0; i < 9 && (Chunk != 0 || !Scaled.IsZero()); i++) { // 最高的一段不补前导0
+				Digits[Count++] = (char)('0' + Chunk % 10);
+				Chunk /= 10;
+			}
+		} while (!Scaled.IsZero());
+		while (Count <= precision) { // 整数部分至少一位
+			Digits[Count++] = '0';
+		}
+		if (std::signbit(value)) {
+			*out++ = '-';
+		}
+		while (Count > precision) {
+			*out++ = Digits[--Count];
+		}
+		if (precision > 0) {
+			*out++ = '.';
+			while (Count > 0) {
+				*out++ = Digits[--Count];
+			}
+		}
+		return out;
+	}
+
+	// 定点格式，结果与printf("%.*f", precision, value)相同，precision最大为20
+	// 单精度数乘以10^precision（precision<=9）在双精度下是精确的，按当前舍入模式（默认为就近偶数）取整后与printf的舍入一致；
+	// 超出快速路径范围（|value|*10^precision>=9e18或precision>9）时用大整数精确计算
+	inline char* FormatFixed(char* out, float value, int precision) {
+		static const double POW10[TEXT_MAX_PRECISION + 1] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+		if (!std::isfinite(value)) {
+			return FormatNonFinite(out, value);
+		}
+		if (precision < 0) {
+			precision = 0;
+		}
+		const double Abs = std::fabs((double)value);
+		if (precision > TEXT_MAX_PRECISION || !(Abs * POW10[precision] < 9e18)) {
+			return FormatFixedExact(out, value, (precision < 20) ? precision : 20);
+		}
+		const uint64_t Scaled = (uint64_t)std::nearbyint(Abs * POW10[precision]);
+		const uint64_t Unit = (uint64_t)POW10[precision];
+		if (std::signbit(value)) {
+			*out++ = '-';
+		}
+		out = FormatUInt(out, Scaled / Unit);
+		if (precision > 0) {
+			*out++ = '.';
+			uint64_t Fraction = Scaled % Unit;
+			for (int i = precision - 1; i >= 0; i--) {
+				out[i] = (char)('0' + Fraction % 10);
+				Fraction /= 10;
+			}
+			out += precision;
+		}
+		return out;
+	}
+
+	// 能被解析回同一个单精度数的最短的十进制数字（Steele-White/Burger-Dybvig算法），value为有限的非零数
+	// 结果为0.Digits * 10^(*pPoint)，返回数字的个数（最多9位）
+	inline int ShortestDigits(float value, char* digits, int* pPoint) {
+		uint32_t Mantissa;
+		int Exponent;
+		const int Biased = DecomposeFloat(value, &Mantissa, &Exponent);
+		const bool Even = (Mantissa & 1) == 0;            // 尾数为偶数时，恰好位于区间端点的数也被解析回value
+		const bool Unequal = Mantissa == 0x800000 && Biased > 1; // 2的幂，与下一个较小的数的间距只有一半
+		// value = R / S，相邻的单精度数的中点为(R ± M) / S
+		TextBigInt R(Mantissa), S(1), MPlus(1), MMinus(1);
+		const int Shift = Unequal ? 2 : 1;
+		R.ShiftLeft(Shift);
+		MPlus.ShiftLeft(Shift - 1);
+		if (Exponent >= 0) {
+			R.ShiftLeft(Exponent);
+			MPlus.ShiftLeft(Exponent);
+			MMinus.ShiftLeft(Exponent);
+			S.ShiftLeft(Shift);
+		}
+		else {
+			S.ShiftLeft(Shift - Exponent);
+		}
+		int Point = (int)std::ceil(std::log10(std::fabs((double)value)) - 1e-10);
+		if (Point >= 0) {
+			S.MulPow10(Point);
+		}
+		else {
+			R.MulPow10(-Point);
+			MPlus.MulPow10(-Point);
+			MMinus.MulPow10(-Point);
+		}
+		// 修正估计的Point，使R + MPlus不超过S
+		TextBigInt High = R;
+		High.Add(MPlus);
+		if (TextBigInt::Compare(High, S) >= (Even ? 0 : 1)) {
+			S.MulSmall(10);
+			Point++;
+		}
+		int Count = 0;
+		for (;;) {
+			R.MulSmall(10);
+			MPlus.MulSmall(10);
+			MMinus.MulSmall(10);
+			uint32_t Digit = R.DivSmallQuotient(S);
+			High = R;
+			High.Add(MPlus);
+			const int LowCmp = TextBigInt::Compare(R, MMinus);
+			const int HighCmp = TextBigInt::Compare(High, S);
+			const bool Low = Even ? (LowCmp <= 0) : (LowCmp < 0);
+			const bool Up = Even ? (HighCmp >= 0) : (HighCmp > 0);
+			if (!Low && !Up) {
+				digits[Count++] = (char)('0' + Digit);
+				continue;
+			}
+			if (Low && Up) { // 两个都可以，取更接近的
+				TextBigInt Twice = R;
+				Twice.ShiftLeft(1);
+				Digit += (TextBigInt::Compare(Twice, S) >= 0) ? 1 : 0;
+			}
+			else if (Up) {
+				Digit++;
+			}
+			digits[Count++] = (char)('0' + Digit);
+			break;
+		}
+		*pPoint = Point;
+		return Count;
+	}
+
+	// 最短格式：能被解析回同一个单精度数的最少位数，如0.1f为"0.1"，1653.801f为"1653.801"
+	// |value|在[1e-4, 1e9)内时为定点格式，否则为与printf("%g")相同的指数格式，如"1.5e-05"、"3.4028235e+38"
+	inline char* FormatShortest(char* out, float value) {
+		static const double POW10[TEXT_MAX_PRECISION + 1] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+		if (!std::isfinite(value)) {
+			return FormatNonFinite(out, value);
+		}
+		const double Abs = std::fabs((double)value);
+		if (value == 0.0f) {
+			return FormatFixed(out, value, 0);
+		}
+		if (Abs >= 1e-4 && Abs < 1e9) { // 快速路径：最少的小数位数
+			for (int Precision = 0; Precision <= TEXT_MAX_PRECISION; Precision++) {
+				const double Rounded = std::nearbyint(Abs * POW10[Precision]) / POW10[Precision];
+				if ((float)Rounded == (float)Abs) {
+					return FormatFixed(out, value, Precision);
+				}
+			}
+		}
+		char Digits[TEXT_MAX_PRECISION + 1];
+		int Point;
+		const int Count = ShortestDigits(value, Digits, &Point);
+		if (std::signbit(value)) {
+			*out++ = '-';
+		}
+		if (Point > -4 && Point <= 9) { // 定点格式
+			if (Point <= 0) {
+				*out++ = '0';
+				*out++ = '.';
+				for (int i = Point; i < 0; i++) {
+					*out++ = '0';
+				}
+				memcpy(out, Digits, Count);
+				return out + Count;
+			}
+			for (int i = 0; i < Point; i++) {
+				*out++ = (i < Count) ? Digits[i] : '0';
+			}
+			if (Count > Point) {
+				*out++ = '.';
+				memcpy(out, Digits + Point, Count - Point);
+				out += Count - Point;
+			}
+			return out;
+		}
+		*out++ = Digits[0];
+		if (Count > 1) {
+			*out++ = '.';
+			memcpy(out, Digits + 1, Count - 1);
+			out += Count - 1;
+		}
+		*out++ = 'e';
+		const int Exp = Point - 1;
+		*out++ = (Exp < 0) ? '-' : '+';
+		if (Exp > -10 && Exp < 10) {
+			*out++ = '0';
+		}
+		return FormatUInt(out, (uint64_t)((Exp < 0) ? -Exp : Exp));
+	}
+
+	// precision小于0时为最短格式，否则为定点格式
+	inline char* FormatFloat(char* out, float value, int precision) {
+		return (precision < 0) ? FormatShortest(out, value) : FormatFixed(out, value, precision);
+	}
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#ifdef WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif // WIN32
+#include <cerrno>
+#include <memory>
+#include <string>
+#include "ForceSensor.hpp"
+#include "TextFormat.hpp"
+
+namespace sia {
+	static constexpr size_t TEXT_WRITER_BUFFER_SIZE = 64 * 1024;                              // 默认批量写入的缓冲区大小
+	static constexpr size_t SAMPLE_TEXT_MAX_SIZE = 2 * TEXT_NUMBER_MAX_SIZE + DATA_TEXT_MAX_SIZE; // FormatSample输出的最大长度
+
+	// 采样的文本格式，默认为CSV：接收时刻,序号,Fx,Fy,Fz,Tx,Ty,Tz
+	struct SampleTextFormat {
+		int Precision = 6;        // 小数位数，小于0时为能还原同一个数的最短格式
+		char Separator = ',';     // 分隔符
+		bool ReceiveTime = true;  // 是否输出ReceiveTimeNs
+		bool Sequence = true;     // 是否输出Sequence
+	};
+
+	// 将一个采样格式化为一行（以'\n'结尾），返回写入结束的位置，不写'\0'，out须至少有SAMPLE_TEXT_MAX_SIZE字节
+	inline char* FormatSample(char* out, const ForceSensorSample& sample, const SampleTextFormat& format = SampleTextFormat()) {
+		if (format.ReceiveTime) {
+			out = FormatInt(out, sample.ReceiveTimeNs);
+			*out++ = format.Separator;
+		}
+		if (format.Sequence) {
+			out = FormatUInt(out, sample.Sequence);
+			*out++ = format.Separator;
+		}
+		out = FormatData(out, sample.Data, format.Precision, format.Separator);
+		out[-1] = '\n'; // 最后一个分隔符改为换行
+		return out;
+	}
+	// 表头，与FormatSample的列对应
+	inline std::string SampleTextHeader(const SampleTextFormat& format = SampleTextFormat()) {
+		static const char* DATA_NAMES[DATA_COUNT] = { "fx", "fy", "fz", "tx", "ty", "tz" };
+		std::string Header;
+		if (format.ReceiveTime) {
+			Header += "receive_ns";
+			Header += format.Separator;
+		}
+		if (format.Sequence) {
+			Header += "sequence";
+			Header += format.Separator;
+		}
+		for (int i = 0; i < DATA_COUNT; i++) {
+			Header += DATA_NAMES[i];
+			Header += (i + 1 < DATA_COUNT) ? format.Separator : '\n';
+		}
+		return Header;
+	}
+
+	// 文本（CSV）导出：采样格式化到内部缓冲区，缓冲区将满或Flush时一次write()写出
+	// 可作为ForceSensor的数据帧接收者（只输出有效采样），也可直接调用Write/WriteBatch导出已读取的采样。
+	// 单写者，不加锁；作为接收者时write()在读取线程中执行，对读取延迟敏感时应使用ForceSensorRecorder。
+	class ForceSensorTextWriter : public ForceSensorSink {
+	public:
+		explicit ForceSensorTextWriter(const SampleTextFormat& format = SampleTextFormat(), size_t bufferSize = TEXT_WRITER_BUFFER_SIZE)
+			: m_Format(format), m_Capacity(std::max(bufferSize, SAMPLE_TEXT_MAX_SIZE)), m_pBuffer(new char[m_Capacity]) {}
+		ForceSensorTextWriter(const ForceSensorTextWriter& other) = delete;
+		ForceSensorTextWriter& operator=(const ForceSensorTextWriter& other) = delete;
+		~ForceSensorTextWriter() { Close(); }
+
+		// 创建（覆盖）文件并开始写入，header为true时先写表头
+		bool Open(const std::string& path, bool header = true) {
+			Close();
+#ifdef WIN32
+			m_Fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+			m_Fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif // WIN32
+			if (m_Fd < 0) {
+				return false;
+			}
+			m_OwnsFd = true;
+			return !header || WriteHeader();
+		}
+		// 写入已打开的文件描述符（如标准输出的1），关闭时不关闭该描述符
+		bool Attach(int fd, bool header = false) {
+			Close();
+			if (fd < 0) {
+				return false;
+			}
+			m_Fd = fd;
+			m_OwnsFd = false;
+			return !header || WriteHeader();
+		}
+		// 写出缓冲区中剩余的数据并关闭
+		void Close() {
+			if (m_Fd < 0) {
+				return;
+			}
+			Flush();
+			if (m_OwnsFd) {
+#ifdef WIN32
+				_close(m_Fd);
+#else
+				close(m_Fd);
+#endif // WIN32
+			}
+			m_Fd = -1;
+		}
+		bool IsOpen() const {
+			return m_Fd >= 0;
+		}
+
+		bool WriteHeader() {
+			const std::string Header = SampleTextHeader(m_Format);
+			if (m_Size + Header.size() > m_Capacity && !Flush()) {
+				return false;
+			}
+			memcpy(m_pBuffer.get() + m_Size, Header.data(), Header.size());
+			m_Size += Header.size();
+			return true;
+		}
+		// 追加一个采样，缓冲区将满时先写出
+		bool Write(const ForceSensorSample& sample) {
+			if (m_Fd < 0 || (m_Size + SAMPLE_TEXT_MAX_SIZE > m_Capacity && !Flush())) {
+				return false;
+			}
+			m_Size = (size_t)(FormatSample(m_pBuffer.get() + m_Size, sample, m_Format) - m_pBuffer.get());
+			m_LineCount++;
+			return true;
+		}
+		// 追加多个采样，如ReadSamples或PeekSamples得到的一批
+		bool WriteBatch(const ForceSensorSample* samples, size_t count) {
+			for (size_t i = 0; i < count; i++) {
+				if (!Write(samples[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		void OnFrame(const ForceSensorSample& sample, const ForceSensorBuffer& buffer) override {
+			(void)buffer;
+			if (sample.Status == SAMPLE_VALID) {
+				Write(sample);
+			}
+		}
+		// 将缓冲区中的数据写出，通常只需一次write()
+		bool Flush() {
+			size_t Offset = 0;
+			while (Offset < m_Size) {
+#ifdef WIN32
+				const int Written = _write(m_Fd, m_pBuffer.get() + Offset, (unsigned int)(m_Size - Offset));
+#else
+				const ssize_t Written = write(m_Fd, m_pBuffer.get() + Offset, m_Size - Offset);
+#endif // WIN32
+				if (Written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					memmove(m_pBuffer.get(), m_pBuffer.get() + Offset, m_Size - Offset); // 保留未写出的数据
+					m_Size -= Offset;
+					return false;
+				}
+				Offset += (size_t)Written;
+				m_WriteCount++;
+			}
+			m_Size = 0;
+			return true;
+		}
+
+		// 已写入的采样行数（不含表头）
+		uint64_t LineCount() const {
+			return m_LineCount;
+		}
+		// 调用write()的次数
+		uint64_t WriteCount() const {
+			return m_WriteCount;
+		}
+
+	private:
+		SampleTextFormat m_Format;
+		size_t m_Capacity;
+		std::unique_ptr<char[]> m_pBuffer; // 批量写入的缓冲区
+		size_t m_Size = 0;                 // 缓冲区中待写出的字节数
+		int m_Fd = -1;
+		bool m_OwnsFd = false;
+		uint64_t m_LineCount = 0;
+		uint64_t m_WriteCount = 0;
+	};
+}
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SerialPort.hpp"
+
+namespace sia {
+	// 无对应系统句柄时NativeHandle()的返回值
+	inline SerialNativeHandle InvalidNativeHandle() {
+#ifdef WIN32
+		return INVALID_HANDLE_VALUE;
+#else
+		return -1;
+#endif // WIN32
+	}
+
+	// 传输层接口，ForceSensor只通过该接口收发字节
+	// Read不等待，只取出已到达的数据；ReadFor/ReadUntil在到达deadline前等待，语义与SerialPort相同。
+	class Transport {
+	public:
+		virtual ~Transport() {}
+
+		virtual bool Open() = 0;
+		virtual void Close() = 0;
+		virtual bool IsOpen() const = 0;
+		// 原生句柄，供SensorReactor等外部事件循环使用，内存实现返回InvalidNativeHandle()
+		virtual SerialNativeHandle NativeHandle() const = 0;
+
+		virtual int Read(char* data, int count) = 0;
+		// 读取count个字节，最多等待timeout，返回实际读取的字节数
+		virtual int ReadFor(char* data, int count, const std::chrono::microseconds& timeout) = 0;
+		// 读取数据直到收到结束符、读满count个字节或到达deadline，返回实际读取的字节数
+		virtual int ReadUntil(char* data, int count, char terminator, const SerialTimePoint& deadline) = 0;
+		virtual int Write(const char* data, int count) = 0;
+		// 丢弃尚未读取的数据
+		virtual void Flush() = 0;
+		// 已到达但尚未读取的字节数，失败时返回-1
+		virtual int Available() = 0;
+	};
+
+	// 串口实现，伪终端（如DynPickSimulator）同样使用该实现，端口名为从设备名
+	class SerialTransport final : public Transport {
+	public:
+		explicit SerialTransport() : m_SerialPort() {}
+		explicit SerialTransport(const SerialConfig& cfg) : m_SerialPort(cfg) {}
+
+		bool Open() override {
+			return m_SerialPort.Open();
+		}
+		void Close() override {
+			m_SerialPort.Close();
+		}
+		bool IsOpen() const override {
+			return m_SerialPort.IsOpen();
+		}
+		SerialNativeHandle NativeHandle() const override {
+			return m_SerialPort.NativeHandle();
+		}
+		int Read(char* data, int count) override {
+			return m_SerialPort.Read(data, count);
+		}
+		int ReadFor(char* data, int count, const std::chrono::microseconds& timeout) override {
+			return m_SerialPort.ReadFor(data, count, timeout);
+		}
+		int ReadUntil(char* data, int count, char terminator, const SerialTimePoint& deadline) override {
+			return m_SerialPort.ReadUntil(data, count, terminator, deadline);
+		}
+		int Write(const char* data, int count) override {
+			return m_SerialPort.Write(data, count);
+		}
+		void Flush() override {
+			m_SerialPort.Flush();
+		}
+		int Available() override {
+			return m_SerialPort.Available();
+		}
+
+		SerialPort& GetSerialPort() {
+			return m_SerialPort;
+		}
+
+	private:
+		SerialPort m_SerialPort;
+	};
+
+	// 内存回环实现，用于无设备时测试解析及缓冲路径
+	// 主机端：Write写入的字节交给应答函数（未设置时存入发送缓冲区，由设备端Drain取出）；
+	// 设备端：Inject写入的字节由主机端Read/ReadUntil读出。应答函数在Write中同步调用，无需额外线程。
+	class LoopbackTransport final : public Transport {
+	public:
+		// 应答函数，参数为主机写入的数据，可在其中调用Inject返回应答
+		using Responder = std::function<void(const char* data, int count, LoopbackTransport& transport)>;
+
+		explicit LoopbackTransport() {}
+		explicit LoopbackTransport(const Responder& responder) : m_Responder(responder) {}
+
+		bool Open() override {
+			m_Open = true;
+			return true;
+		}
+		void Close() override {
+			m_Open = false;
+			m_Readable.notify_all();
+		}
+		bool IsOpen() const override {
+			return m_Open;
+		}
+		SerialNativeHandle NativeHandle() const override {
+			return InvalidNativeHandle();
+		}
+
+		int Read(char* data, int count) override {
+			if (!m_Open) {
+				return -1;
+			}
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			return TakeLocked(data, count);
+		}
+		int ReadFor(char* data, int count, const std::chrono::microseconds& timeout) override {
+			return ReadWithDeadline(data, count, -1, SerialClock::now() + timeout);
+		}
+		int ReadUntil(char* data, int count, char terminator, const SerialTimePoint& deadline) override {
+			return ReadWithDeadline(data, count, (unsigned char)terminator, deadline);
+		}
+		int Write(const char* data, int count) override {
+			if (!m_Open) {
+				return -1;
+			}
+			if (m_Responder) {
+				m_Responder(data, count, *this);
+			}
+			else {
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+				m_TxBuffer.insert(m_TxBuffer.end(), data, data + count);
+			}
+			return count;
+		}
+		void Flush() override {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_RxBuffer.clear();
+			m_RxHead = 0;
+			m_TxBuffer.clear();
+		}
+
+		// [设备端] 写入供主机读取的数据
+		void Inject(const char* data, size_t count) {
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+				if (m_RxHead > 0 && m_RxHead * 2 >= m_RxBuffer.size()) { // 已读部分过半时整理，避免缓冲区无限增长
+					m_RxBuffer.erase(m_RxBuffer.begin(), m_RxBuffer.begin() + m_RxHead);
+					m_RxHead = 0;
+				}
+				m_RxBuffer.insert(m_RxBuffer.end(), data, data + count);
+			}
+			m_Readable.notify_one();
+		}
+		// [设备端] 取出主机写入的数据，返回实际取出的字节数
+		size_t Drain(char* data, size_t count) {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			count = std::min(count, m_TxBuffer.size());
+			memcpy(data, m_TxBuffer.data(), count);
+			m_TxBuffer.erase(m_TxBuffer.begin(), m_TxBuffer.begin() + count);
+			return count;
+		}
+		// 尚未被主机读取的字节数
+		int Available() override {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			return (int)(m_RxBuffer.size() - m_RxHead);
+		}
+
+	private:
+		int TakeLocked(char* data, int count) {
+			const size_t Count = std::min((size_t)count, m_RxBuffer.size() - m_RxHead);
+			memcpy(data, m_RxBuffer.data() + m_RxHead, Count);
+			m_RxHead += Count;
+			return (int)Count;
+		}
+		int ReadWithDeadline(char* data, int count, int terminator, const SerialTimePoint& deadline) {
+			if (!m_Open) {
+				return -1;
+			}
+			int Total = 0;
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			while (Total < count) {
+				if (!m_Readable.wait_until(Lock, deadline, [this]() { return m_RxHead < m_RxBuffer.size() || !m_Open; })) {
+					break; // 超时
+				}
+				int ReadByteCount = TakeLocked(data + Total, count - Total);
+				if (ReadByteCount == 0) { // 已关闭
+					break;
+				}
+				bool Found = (terminator >= 0 && memchr(data + Total, terminator, ReadByteCount) != nullptr);
+				Total += ReadByteCount;
+				if (Found) {
+					break;
+				}
+			}
+			return Total;
+		}
+
+		Responder m_Responder;
+		std::atomic<bool> m_Open{ false };
+		std::mutex m_Mutex;
+		std::condition_variable m_Readable;
+		std::vector<char> m_RxBuffer; // 设备端 -> 主机端
+		size_t m_RxHead = 0;          // 已读取的位置
+		std::vector<char> m_TxBuffer; // 主机端 -> 设备端
+	};
+
+	// 回放实现，按录制时的时间间隔（或尽快）输出录制的字节流，主机写入的数据被丢弃
+	// 录制数据由若干块组成，每块带有相对录制开始时刻的时间戳，Open()时开始计时。
+	class ReplayTransport final : public Transport {
+	public:
+		explicit ReplayTransport(bool realTime = true) : m_RealTime(realTime) {}
+
+		// 追加一块录制数据，timeNs为相对录制开始的时刻，须单调不减
+		void Append(int64_t timeNs, const char* data, size_t size) {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_Chunks.push_back({ timeNs, m_Data.size() });
+			m_Data.insert(m_Data.end(), data, data + size);
+		}
+		// 读取原始字节流文件，作为时刻0的一块数据，即尽快回放
+		bool LoadRaw(const std::string& path) {
+			std::ifstream File(path, std::ios::binary);
+			if (!File) {
+				return false;
+			}
+			std::vector<char> Data((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+			Append(0, Data.data(), Data.size());
+			return true;
+		}
+		// true按录制时的时间间隔回放，false尽快回放
+		void SetRealTime(bool realTime) {
+			m_RealTime = realTime;
+		}
+		// 回放结束后是否从头重新开始
+		void SetLoop(bool loop) {
+			m_Loop = loop;
+		}
+		// 回到开头并重新计时
+		void Rewind() {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_Position = 0;
+			m_StartTime = SerialClock::now();
+		}
+		// 所有数据均已被读取
+		bool IsFinished() {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			return !m_Loop && m_Position >= m_Data.size();
+		}
+		// 主机写入（被丢弃）的字节数
+		uint64_t WrittenBytes() const {
+			return m_WrittenBytes;
+		}
+
+		bool Open() override {
+			Rewind();
+			m_Open = true;
+			return true;
+		}
+		void Close() override {
+			m_Open = false;
+		}
+		bool IsOpen() const override {
+			return m_Open;
+		}
+		SerialNativeHandle NativeHandle() const override {
+			return InvalidNativeHandle();
+		}
+
+		int Read(char* data, int count) override {
+			if (!m_Open) {
+				return -1;
+			}
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			return TakeLocked(data, count, SerialClock::now());
+		}
+		int ReadFor(char* data, int count, const std::chrono::microseconds& timeout) override {
+			return ReadWithDeadline(data, count, -1, SerialClock::now() + timeout);
+		}
+		int ReadUntil(char* data, int count, char terminator, const SerialTimePoint& deadline) override {
+			return ReadWithDeadline(data, count, (unsigned char)terminator, deadline);
+		}
+		int Write(const char* data, int count) override {
+			(void)data;
+			if (!m_Open) {
+				return -1;
+			}
+			m_WrittenBytes += count;
+			return count;
+		}
+		// 回放数据按时间输出，不丢弃
+		void Flush() override {}
+		// 当前时刻已可读取的字节数
+		int Available() override {
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			const size_t End = AvailableEndLocked(SerialClock::now());
+			return (End > m_Position) ? (int)(End - m_Position) : 0;
+		}
+
+	private:
+		struct Chunk {
+			int64_t TimeNs; // 相对录制开始的时刻
+			size_t Offset;  // 在m_Data中的起始位置
+		};
+
+		// 当前时刻可读到的数据末尾位置
+		size_t AvailableEndLocked(const SerialTimePoint& now) const {
+			if (!m_RealTime) {
+				return m_Data.size();
+			}
+			const int64_t ElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_StartTime).count();
+			auto It = std::upper_bound(m_Chunks.begin(), m_Chunks.end(), ElapsedNs,
+				[](int64_t timeNs, const Chunk& chunk) { return timeNs < chunk.TimeNs; });
+			return (It == m_Chunks.end()) ? m_Data.size() : It->Offset;
+		}
+		// 下一块数据的输出时刻，即第一个晚于当前时刻的块，与AvailableEndLocked的分界相同
+		SerialTimePoint NextChunkTimeLocked(const SerialTimePoint& now) const {
+			if (!m_RealTime) {
+				return SerialTimePoint::max();
+			}
+			const int64_t ElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_StartTime).count();
+			auto It = std::upper_bound(m_Chunks.begin(), m_Chunks.end(), ElapsedNs,
+				[](int64_t timeNs, const Chunk& chunk) { return timeNs < chunk.TimeNs; });
+			if (It == m_Chunks.end()) {
+				return SerialTimePoint::max();
+			}
+			return m_StartTime + std::chrono::nanoseconds(It->TimeNs);
+		}
+		int TakeLocked(char* data, int count, const SerialTimePoint& now) {
+			if (m_Loop && !m_Data.empty() && m_Position >= m_Data.size()) {
+				m_Position = 0;
+				m_StartTime = now;
+			}
+			const size_t End = AvailableEndLocked(now);
+			if (m_Position >= End) {
+				return 0;
+			}
+			const size_t Count = std::min((size_t)count, End - m_Position);
+			memcpy(data, m_Data.data() + m_Position, Count);
+			m_Position += Count;
+			return (int)Count;
+		}
+		int ReadWithDeadline(char* data, int count, int terminator, const SerialTimePoint& deadline) {
+			if (!m_Open) {
+				return -1;
+			}
+			int Total = 0;
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			while (Total < count) {
+				SerialTimePoint Now = SerialClock::now();
+				int ReadByteCount = TakeLocked(data + Total, count - Total, Now);
+				if (ReadByteCount == 0) {
+					// 等待下一块数据的时刻，数据已读完（与设备无应答相同）或下一块晚于deadline时等到deadline
+					const SerialTimePoint WakeTime = std::min(NextChunkTimeLocked(Now), deadline);
+					if (Now >= deadline) {
+						break;
+					}
+					Lock.unlock();
+					std::this_thread::sleep_until(WakeTime);
+					Lock.lock();
+					continue;
+				}
+				bool Found = (terminator >= 0 && memchr(data + Total, terminator, ReadByteCount) != nullptr);
+				Total += ReadByteCount;
+				if (Found) {
+					break;
+				}
+			}
+			return Total;
+		}
+
+		bool m_RealTime;
+		bool m_Loop = false;
+		std::atomic<bool> m_Open{ false };
+		std::atomic<uint64_t> m_WrittenBytes{ 0 };
+		std::mutex m_Mutex;
+		std::vector<char> m_Data;     // 所有录制数据
+		std::vector<Chunk> m_Chunks;  // 各块的时刻及起始位置
+		size_t m_Position = 0;        // 已读取的位置
+		SerialTimePoint m_StartTime;  // 回放开始的时刻
+	};
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "ForceSensor.hpp"
+#include "Filter.hpp"
+#include "SeqLock.hpp"
+
+namespace sia {
+	using WrenchMatrix = std::array<double, DATA_COUNT * DATA_COUNT>; // 6x6矩阵，按行存放
+	using RotationMatrix = std::array<double, 9>;                     // 3x3旋转矩阵，按行存放
+	using Vector3 = std::array<double, 3>;
+
+	// 标定及工具坐标系变换
+	// 对解析后的数据 w = [Fx Fy Fz Tx Ty Tz] 依次做：
+	//   1. 6x6标定（解耦）矩阵 C：w_s = C * w
+	//   2. 刚体力旋量变换到工具坐标系：F_t = R^T * F_s，T_t = R^T * (T_s - p x F_s)
+	//      R为工具坐标系相对传感器坐标系的姿态（列为工具坐标轴在传感器坐标系中的方向），p为工具中心点在传感器坐标系中的位置
+	// 两者预先合并为一个6x6矩阵，每个数据只做一次按列的SIMD矩阵乘法（6次乘加，每次8个通道）。
+	// 配置函数须在同一线程中调用，可在读取过程中修改，读取线程在下一个数据时生效。
+	class WrenchTransform : public ForceSensorStage {
+	public:
+		explicit WrenchTransform() {
+			Reset();
+		}
+
+		// 恢复为单位矩阵
+		void Reset() {
+			m_Calibration = Identity6();
+			m_Rotation = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+			m_Position = { 0.0, 0.0, 0.0 };
+			Fuse();
+		}
+		// 设置6x6标定矩阵，按行存放
+		void SetCalibration(const WrenchMatrix& matrix) {
+			m_Calibration = matrix;
+			Fuse();
+		}
+		// 设置工具坐标系，rotation按行存放，position与力矩的长度单位一致
+		void SetToolFrame(const RotationMatrix& rotation, const Vector3& position) {
+			m_Rotation = rotation;
+			m_Position = position;
+			Fuse();
+		}
+		// 合并后的矩阵，按行存放
+		WrenchMatrix GetMatrix() const {
+			return m_Matrix;
+		}
+
+		// 读取线程中原地变换
+		bool Process(ForceSensorData& data) override {
+			const uint64_t Version = m_Published.Version();
+			if (Version != m_AppliedVersion) { // 配置已修改，重新加载
+				LoadColumns(m_Published.Load());
+				m_AppliedVersion = Version;
+			}
+			Apply(data.data(), data.data());
+			return true;
+		}
+		// 变换一个数据，in与out可相同
+		void Transform(const ForceSensorData& in, ForceSensorData* pOut) {
+			Process(*pOut = in);
+		}
+
+	private:
+		using ColumnArray = std::array<float, DATA_COUNT * FILTER_LANE_COUNT>; // 按列存放，每列补齐为8个
+
+		void Apply(const float* in, float* out) const {
+			FilterLanes Sum = m_Columns[0] * LanesSet(in[0]);
+			for (int j = 1; j < DATA_COUNT; j++) {
+				Sum = Sum + m_Columns[j] * LanesSet(in[j]);
+			}
+			float Buffer[FILTER_LANE_COUNT];
+			LanesStore(Buffer, Sum);
+			memcpy(out, Buffer, sizeof(float) * DATA_COUNT);
+		}
+
+		static WrenchMatrix Identity6() {
+			WrenchMatrix Matrix = {};
+			for (int i = 0; i < DATA_COUNT; i++) {
+				Matrix[i * DATA_COUNT + i] = 1.0;
+			}
+			return Matrix;
+		}
+
+		// M = X * C，X = [R^T 0; -R^T [p]x  R^T]，以双精度计算后转为单精度发布
+		void Fuse() {
+			WrenchMatrix X = {};
+			const double* R = m_Rotation.data();
+			const double* P = m_Position.data();
+			// [p]x 叉乘矩阵
+			const double Skew[9] = { 0.0, -P[2], P[1], P[2], 0.0, -P[0], -P[1], P[0], 0.0 };
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					const double Rt = R[j * 3 + i]; // R^T(i, j)
+					X[i * DATA_COUNT + j] = Rt;
+					X[(i + 3) * DATA_COUNT + j + 3] = Rt;
+					double RtSkew = 0.0; // (R^T * [p]x)(i, j)
+					for (int k = 0; k < 3; k++) {
+						RtSkew += R[k * 3 + i] * Skew[k * 3 + j];
+					}
+					X[(i + 3) * DATA_COUNT + j] = -RtSkew;
+				}
+			}
+			for (int i = 0; i < DATA_COUNT; i++) {
+				for (int j = 0; j < DATA_COUNT; j++) {
+					double Sum = 0.0;
+					for (int k = 0; k < DATA_COUNT; k++) {
+						Sum += X[i * DATA_COUNT + k] * m_Calibration[k * DATA_COUNT + j];
+					}
+					m_Matrix[i * DATA_COUNT + j] = Sum;
+				}
+			}
+			ColumnArray Columns = {};
+			for (int j = 0; j < DATA_COUNT; j++) {
+				for (int i = 0; i < DATA_COUNT; i++) {
+					Columns[j * FILTER_LANE_COUNT + i] = (float)m_Matrix[i * DATA_COUNT + j];
+				}
+			}
+			m_Published.Store(Columns);
+		}
+		void LoadColumns(const ColumnArray& columns) {
+			for (int j = 0; j < DATA_COUNT; j++) {
+				m_Columns[j] = LanesLoad(&columns[j * FILTER_LANE_COUNT]);
+			}
+		}
+
+		// 配置线程
+		WrenchMatrix m_Calibration;
+		RotationMatrix m_Rotation;
+		Vector3 m_Position;
+		WrenchMatrix m_Matrix;
+		SeqLock<ColumnArray> m_Published; // 发布给读取线程的合并矩阵
+
+		// 读取线程
+		FilterLanes m_Columns[DATA_COUNT];
+		uint64_t m_AppliedVersion = UINT64_MAX;
+	};
+}
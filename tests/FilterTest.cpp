@@ -0,0 +1,121 @@
+// ForceSensorFilter的阶跃响应、滑动平均、抽取及去皮测试
+#include <cmath>
+#include "Filter.hpp"
+#include "TestCheck.hpp"
+
+static const sia::ForceSensorData AMPLITUDE = { 1.0f, -2.0f, 10.0f, 0.5f, -0.25f, 100.0f };
+
+static sia::ForceSensorData Scaled(float k) {
+	sia::ForceSensorData Data;
+	for (int i = 0; i < sia::DATA_COUNT; i++) {
+		Data[i] = AMPLITUDE[i] * k;
+	}
+	return Data;
+}
+
+// 2阶及4阶Butterworth低通的单位阶跃响应：与双精度的直接实现一致，超调量与理论值相符，最终收敛到阶跃值
+static void TestLowPassStep(int order, double expectedOvershoot) {
+	const double SAMPLE_RATE = 1000.0;
+	const double CUTOFF = 50.0;
+	sia::ForceSensorFilter Filter;
+	SIA_CHECK(Filter.SetLowPass(SAMPLE_RATE, CUTOFF, order));
+	const int StageCount = order / 2;
+	sia::BiquadCoeffs Coeffs[2] = { sia::LowPassBiquad(SAMPLE_RATE, CUTOFF, (order == 2) ? 0.70710678 : 0.54119610),
+		sia::LowPassBiquad(SAMPLE_RATE, CUTOFF, 1.30656296) };
+	double X1[2] = {}, X2[2] = {}, Y1[2] = {}, Y2[2] = {}; // 参考实现的状态，从0开始的稳态
+	sia::ForceSensorData Data = Scaled(0.0f);
+	SIA_CHECK(Filter.Process(Data) && Data == Scaled(0.0f));
+	double MaxError = 0.0;
+	double Peak = 0.0;
+	for (int n = 0; n < 500; n++) {
+		double X = 1.0;
+		for (int s = 0; s < StageCount; s++) {
+			const sia::BiquadCoeffs& C = Coeffs[s];
+			const double Y = C.B[0] * X + C.B[1] * X1[s] + C.B[2] * X2[s] - C.A[1] * Y1[s] - C.A[2] * Y2[s];
+			X2[s] = X1[s];
+			X1[s] = X;
+			Y2[s] = Y1[s];
+			Y1[s] = Y;
+			X = Y;
+		}
+		Data = Scaled(1.0f);
+		SIA_CHECK(Filter.Process(Data));
+		for (int i = 0; i < sia::DATA_COUNT; i++) {
+			MaxError = std::fmax(MaxError, std::fabs(Data[i] / AMPLITUDE[i] - X));
+		}
+		Peak = std::fmax(Peak, Data[0]);
+	}
+	SIA_CHECK(MaxError < 1e-4);
+	SIA_CHECK_NEAR(Peak - 1.0, expectedOvershoot, 0.005);
+	for (int i = 0; i < sia::DATA_COUNT; i++) {
+		SIA_CHECK_NEAR(Data[i], AMPLITUDE[i], 1e-4 * std::fabs(AMPLITUDE[i]));
+	}
+}
+
+// 第一个数据作为稳态初始化，恒定输入没有过渡过程
+static void TestPrimed() {
+	sia::ForceSensorFilter Filter;
+	Filter.SetLowPass(1000.0, 10.0, 4);
+	Filter.SetMovingAverage(8);
+	bool Constant = true;
+	for (int n = 0; n < 50; n++) {
+		sia::ForceSensorData Data = Scaled(3.0f);
+		Filter.Process(Data);
+		for (int i = 0; i < sia::DATA_COUNT; i++) {
+			Constant = Constant && std::fabs(Data[i] - 3.0f * AMPLITUDE[i]) <= 1e-4f * std::fabs(3.0f * AMPLITUDE[i]);
+		}
+	}
+	SIA_CHECK(Constant);
+}
+
+// 窗口为4的滑动平均的阶跃响应为4步的斜坡，之后按3:1抽取
+static void TestMovingAverageAndDecimation() {
+	sia::ForceSensorFilter Filter;
+	SIA_CHECK(Filter.SetMovingAverage(4));
+	sia::ForceSensorData Data = Scaled(0.0f);
+	Filter.Process(Data);
+	const float Ramp[] = { 0.25f, 0.5f, 0.75f, 1.0f, 1.0f };
+	for (float Expected : Ramp) {
+		Data = Scaled(1.0f);
+		SIA_CHECK(Filter.Process(Data));
+		SIA_CHECK_NEAR(Data[2], Expected * AMPLITUDE[2], 1e-5);
+	}
+	SIA_CHECK(Filter.SetDecimation(3));
+	int Output = 0;
+	for (int n = 0; n < 30; n++) {
+		Data = Scaled(1.0f);
+		Output += Filter.Process(Data) ? 1 : 0;
+	}
+	SIA_CHECK(Output == 10);
+}
+
+// 去皮：之后的数据减去去皮期间的平均值
+static void TestTare() {
+	sia::ForceSensorFilter Filter;
+	Filter.StartTare(10);
+	SIA_CHECK(Filter.IsTaring());
+	sia::ForceSensorData Data;
+	for (int n = 0; n < 10; n++) {
+		Data = Scaled((n % 2 == 0) ? 4.0f : 6.0f);
+		Filter.Process(Data);
+	}
+	SIA_CHECK(!Filter.IsTaring());
+	const sia::ForceSensorData Bias = Filter.GetBias();
+	for (int i = 0; i < sia::DATA_COUNT; i++) {
+		SIA_CHECK_NEAR(Bias[i], 5.0f * AMPLITUDE[i], 1e-4 * std::fabs(AMPLITUDE[i]));
+	}
+	Data = Scaled(7.0f);
+	Filter.Process(Data);
+	for (int i = 0; i < sia::DATA_COUNT; i++) {
+		SIA_CHECK_NEAR(Data[i], 2.0f * AMPLITUDE[i], 1e-4 * std::fabs(AMPLITUDE[i]));
+	}
+}
+
+int main() {
+	TestLowPassStep(2, 0.0432); // 2阶Butterworth的超调量约4.3%
+	TestLowPassStep(4, 0.1083); // 4阶约10.8%
+	TestPrimed();
+	TestMovingAverageAndDecimation();
+	TestTare();
+	return TestResult("FilterTest");
+}
@@ -0,0 +1,74 @@
+// FrameAssembler的跨读取重组及损坏后的重新同步测试
+#include <string>
+#include <vector>
+#include "FrameAssembler.hpp"
+#include "TestCheck.hpp"
+
+using TestAssembler = sia::FrameAssembler<16>;
+
+// 逐块输入，返回得到的所有帧
+static std::vector<std::string> FeedChunks(TestAssembler& assembler, const std::string& data, size_t chunkSize) {
+	std::vector<std::string> Frames;
+	for (size_t i = 0; i < data.size(); i += chunkSize) {
+		const size_t Count = (data.size() - i < chunkSize) ? data.size() - i : chunkSize;
+		assembler.Feed(&data[i], Count, [&Frames](const char* frame, size_t size) {
+			Frames.emplace_back(frame, size);
+		});
+	}
+	return Frames;
+}
+
+// 帧被拆分到多次读取中，任意的拆分方式都得到相同的帧
+static void TestSplitFrames() {
+	const std::string Data = "abcd\n0123456\nwxyz\n";
+	for (size_t ChunkSize = 1; ChunkSize <= Data.size(); ChunkSize++) {
+		TestAssembler Assembler;
+		Assembler.SetFormat('\n', { 5, 8 });
+		const std::vector<std::string> Frames = FeedChunks(Assembler, Data, ChunkSize);
+		SIA_CHECK(Frames.size() == 3);
+		if (Frames.size() == 3) {
+			SIA_CHECK(Frames[0] == "abcd\n" && Frames[1] == "0123456\n" && Frames[2] == "wxyz\n");
+		}
+		SIA_CHECK(Assembler.FrameCount() == 3 && Assembler.DiscardedBytes() == 0 && Assembler.PendingBytes() == 0);
+	}
+}
+
+// 长度不符的帧被丢弃，在下一个结束符处重新同步
+static void TestResyncAfterBadLength() {
+	TestAssembler Assembler;
+	Assembler.SetFormat('\n', { 5 });
+	const std::vector<std::string> Frames = FeedChunks(Assembler, "cd\nabcd\nabc\nabcdef\nwxyz\n", 4);
+	SIA_CHECK(Frames.size() == 2);
+	if (Frames.size() == 2) {
+		SIA_CHECK(Frames[0] == "abcd\n" && Frames[1] == "wxyz\n");
+	}
+	SIA_CHECK(Assembler.DiscardedBytes() == 3 + 4 + 7);
+}
+
+// 超过最大帧长仍无结束符时丢弃至下一个结束符，之后的帧正常
+static void TestResyncAfterOverlong() {
+	TestAssembler Assembler;
+	Assembler.SetFormat('\n', { 5 });
+	const std::string Garbage(40, 'x');
+	const std::vector<std::string> Frames = FeedChunks(Assembler, Garbage + "yy\nabcd\n", 7);
+	SIA_CHECK(Frames.size() == 1);
+	if (Frames.size() == 1) {
+		SIA_CHECK(Frames[0] == "abcd\n");
+	}
+	SIA_CHECK(Assembler.DiscardedBytes() == Garbage.size() + 3);
+
+	// Reset丢弃残留的半帧
+	const char Partial[] = "ab";
+	Assembler.Feed(Partial, 2, [](const char*, size_t) {});
+	SIA_CHECK(Assembler.PendingBytes() == 2);
+	Assembler.Reset();
+	SIA_CHECK(Assembler.PendingBytes() == 0 && Assembler.DiscardedBytes() == Garbage.size() + 5);
+	SIA_CHECK(FeedChunks(Assembler, "cd\nefgh\n", 3).size() == 1);
+}
+
+int main() {
+	TestSplitFrames();
+	TestResyncAfterBadLength();
+	TestResyncAfterOverlong();
+	return TestResult("FrameAssemblerTest");
+}
@@ -0,0 +1,68 @@
+// 各十六进制解码器实现与标量实现的一致性测试，CPU不支持的实现退回到可用的实现
+#include <cstring>
+#include <random>
+#include "HexDecoder.hpp"
+#include "TestCheck.hpp"
+
+static const char HEX_DIGITS[] = "0123456789abcdefABCDEF";
+
+// 比较decoder与DecodeHexScalar的返回值，合法时还比较解码结果
+static bool SameAsScalar(sia::HexDecodeFunc decoder, const char* hex, const float* scale) {
+	float Expected[sia::HEX_SCALE_COUNT] = {};
+	float Actual[sia::HEX_SCALE_COUNT] = {};
+	const bool ExpectedValid = sia::DecodeHexScalar(hex, scale, Expected);
+	if (decoder(hex, scale, Actual) != ExpectedValid) {
+		return false;
+	}
+	return !ExpectedValid || memcmp(Expected, Actual, sizeof(float) * sia::HEX_VALUE_COUNT) == 0;
+}
+
+// 标量实现与按位拼出的数值一致
+static void TestScalar() {
+	const float Scale[sia::HEX_SCALE_COUNT] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f };
+	float Out[sia::HEX_SCALE_COUNT] = {};
+	SIA_CHECK(sia::DecodeHexScalar("0000FFFF7fFf8000a5A51234", Scale, Out));
+	SIA_CHECK(Out[0] == 0.0f && Out[1] == 65535.0f && Out[2] == 32767.0f && Out[3] == 32768.0f && Out[4] == 42405.0f && Out[5] == 4660.0f);
+	SIA_CHECK(!sia::DecodeHexScalar("0000FFFF7fFf8000a5A5123g", Scale, Out));
+	SIA_CHECK(!sia::DecodeHexScalar("0000 FFF7fFf8000a5A51234", Scale, Out));
+}
+
+static void TestDecoder(sia::HexDecoderKind kind) {
+	const sia::HexDecodeFunc Decoder = sia::GetHexDecoder(kind);
+	std::mt19937 Random(1234u + (unsigned)kind);
+	float Scale[sia::HEX_SCALE_COUNT] = {};
+	char Hex[32] = {};
+	// 随机的合法字符串，大小写混合
+	for (int n = 0; n < 10000; n++) {
+		for (int i = 0; i < sia::HEX_VALUE_COUNT; i++) {
+			Scale[i] = std::uniform_real_distribution<float>(-2.0f, 2.0f)(Random);
+		}
+		for (int i = 0; i < sia::HEX_CHAR_COUNT; i++) {
+			Hex[i] = HEX_DIGITS[Random() % (sizeof(HEX_DIGITS) - 1)];
+		}
+		SIA_CHECK(SameAsScalar(Decoder, Hex, Scale));
+	}
+	// 每个位置依次替换为所有256个字节值，非法字符的检测与标量实现一致
+	int Mismatch = 0;
+	for (int i = 0; i < sia::HEX_CHAR_COUNT; i++) {
+		const char Saved = Hex[i];
+		for (int c = 0; c < 256; c++) {
+			Hex[i] = (char)c;
+			Mismatch += SameAsScalar(Decoder, Hex, Scale) ? 0 : 1;
+		}
+		Hex[i] = Saved;
+	}
+	SIA_CHECK(Mismatch == 0);
+	// 第24个字符之后的内容不影响结果
+	memset(Hex + sia::HEX_CHAR_COUNT, 'z', sizeof(Hex) - sia::HEX_CHAR_COUNT);
+	SIA_CHECK(SameAsScalar(Decoder, Hex, Scale));
+}
+
+int main() {
+	TestScalar();
+	TestDecoder(sia::HEX_DECODER_SCALAR);
+	TestDecoder(sia::HEX_DECODER_SSSE3);
+	TestDecoder(sia::HEX_DECODER_AVX2);
+	TestDecoder(sia::HEX_DECODER_AUTO);
+	return TestResult("HexDecoderTest");
+}
@@ -0,0 +1,92 @@
+// ForceSensorRecorder写入多个段文件后由ForceSensorRecordReader读回的测试
+#include <cstdio>
+#include <cstring>
+#include "Recorder.hpp"
+#include "TestCheck.hpp"
+
+static const char BASE_PATH[] = "RecorderTest";
+static const size_t RECORDS_PER_SEGMENT = 100;
+static const uint64_t RECORD_COUNT = 1050; // 10个满的段及1个未满的段
+
+static sia::ForceSensorSample MakeSample(uint64_t i) {
+	sia::ForceSensorSample Sample = {};
+	for (int j = 0; j < sia::DATA_COUNT; j++) {
+		Sample.Data[j] = (float)i + 0.125f * (float)j;
+	}
+	Sample.RequestTimeNs = (int64_t)(i * 1000);
+	Sample.ReceiveTimeNs = (int64_t)(i * 1000 + 500);
+	Sample.Sequence = i + 1;
+	Sample.Status = (i % 7 == 3) ? sia::SAMPLE_PARSE_ERROR : sia::SAMPLE_VALID;
+	return Sample;
+}
+static sia::ForceSensorBuffer MakeBuffer(uint64_t i) {
+	sia::ForceSensorBuffer Buffer = {};
+	snprintf((char*)&Buffer[0], Buffer.size(), "frame %llu\r\n", (unsigned long long)i);
+	return Buffer;
+}
+static bool SameRecord(const sia::ForceSensorRecord& record, uint64_t i) {
+	const sia::ForceSensorSample Sample = MakeSample(i);
+	return record.ReceiveTimeNs == Sample.ReceiveTimeNs && record.RequestTimeNs == Sample.RequestTimeNs
+		&& record.Sequence == Sample.Sequence && record.Data == Sample.Data
+		&& record.Status == (uint32_t)Sample.Status && record.Buffer == MakeBuffer(i);
+}
+static void RemoveSegments() {
+	for (size_t i = 0; i < 20; i++) {
+		remove(sia::RecordSegmentPath(BASE_PATH, i).c_str());
+	}
+}
+
+static void TestWriteRead() {
+	RemoveSegments();
+	sia::ForceSensorRecorder Recorder(RECORDS_PER_SEGMENT);
+	SIA_CHECK(Recorder.Open(BASE_PATH));
+	for (uint64_t i = 0; i < RECORD_COUNT; i++) {
+		SIA_CHECK(Recorder.Append(MakeSample(i), MakeBuffer(i)));
+	}
+	SIA_CHECK(Recorder.RecordCount() == RECORD_COUNT);
+
+	// 记录中途即可读取已发布的记录
+	sia::ForceSensorRecordReader Reader;
+	SIA_CHECK(Reader.Open(BASE_PATH) && Reader.Size() == RECORD_COUNT);
+	Reader.Close();
+	Recorder.Close();
+
+	// 预先创建的下一个段文件在Close时被删除
+	const size_t SegmentCount = (size_t)((RECORD_COUNT + RECORDS_PER_SEGMENT - 1) / RECORDS_PER_SEGMENT);
+	FILE* pFile = fopen(sia::RecordSegmentPath(BASE_PATH, SegmentCount - 1).c_str(), "rb");
+	SIA_CHECK(pFile != nullptr);
+	if (pFile != nullptr) {
+		fclose(pFile);
+	}
+	pFile = fopen(sia::RecordSegmentPath(BASE_PATH, SegmentCount).c_str(), "rb");
+	SIA_CHECK(pFile == nullptr);
+	if (pFile != nullptr) {
+		fclose(pFile);
+	}
+
+	SIA_CHECK(Reader.Open(BASE_PATH));
+	SIA_CHECK(Reader.Size() == RECORD_COUNT);
+	uint64_t Index = 0;
+	bool Same = true;
+	Reader.ForEach([&Index, &Same](const sia::ForceSensorRecord& record) {
+		Same = Same && SameRecord(record, Index++);
+	});
+	SIA_CHECK(Same && Index == RECORD_COUNT);
+
+	// 按序号及时刻定位，跨越段文件的边界
+	sia::ForceSensorRecord Record;
+	Reader.Seek(RECORDS_PER_SEGMENT - 1);
+	SIA_CHECK(Reader.Next(&Record) && SameRecord(Record, RECORDS_PER_SEGMENT - 1));
+	SIA_CHECK(Reader.Next(&Record) && SameRecord(Record, RECORDS_PER_SEGMENT));
+	SIA_CHECK(Reader.SeekTime(123 * 1000 + 500) == 123);
+	SIA_CHECK(Reader.SeekTime(123 * 1000 + 501) == 124);
+	SIA_CHECK(Reader.SeekTime(-1) == 0);
+	SIA_CHECK(Reader.SeekTime(INT64_MAX) == RECORD_COUNT && !Reader.Next(&Record));
+	Reader.Close();
+	RemoveSegments();
+}
+
+int main() {
+	TestWriteRead();
+	return TestResult("RecorderTest");
+}
@@ -0,0 +1,177 @@
+// SpscRing、BroadcastRing的回绕、满/空判断、批量读取及被超过一圈的检测测试
+#include <thread>
+#include <vector>
+#include "RingBuffer.hpp"
+#include "TestCheck.hpp"
+
+// 下标远超容量后仍按写入顺序读写，满时Push失败
+static void TestSpscWrapAround() {
+	sia::SpscRing<int, 8> Ring;
+	int Next = 0;
+	int Expected = 0;
+	for (int Round = 0; Round < 100; Round++) {
+		const int Count = 1 + Round % 8;
+		for (int i = 0; i < Count; i++) {
+			SIA_CHECK(Ring.Push(Next++));
+		}
+		SIA_CHECK(Ring.Size() == (size_t)Count);
+		for (int i = 0; i < Count; i++) {
+			int Item = -1;
+			SIA_CHECK(Ring.Pop(&Item));
+			SIA_CHECK(Item == Expected++);
+		}
+		SIA_CHECK(Ring.Empty());
+	}
+	for (int i = 0; i < 8; i++) {
+		SIA_CHECK(Ring.Push(i));
+	}
+	SIA_CHECK(!Ring.Push(8));
+	int Item = -1;
+	SIA_CHECK(Ring.PopLatest(&Item) && Item == 7);
+	SIA_CHECK(Ring.Empty() && !Ring.Pop(&Item));
+}
+
+// PopBatch跨越缓冲区末尾时拼接两段，Peek只返回末尾之前的部分
+static void TestSpscBatch() {
+	sia::SpscRing<int, 8> Ring;
+	for (int i = 0; i < 6; i++) {
+		Ring.Push(i);
+	}
+	int Items[8] = {};
+	SIA_CHECK(Ring.PopBatch(Items, 6) == 6);
+	for (int i = 0; i < 6; i++) { // 读取位置移到6，之后的写入跨越末尾
+		Ring.Push(100 + i);
+	}
+	sia::RingSpan<int> Span = Ring.Peek();
+	SIA_CHECK(Span.Size == 2 && Span[0] == 100 && Span[1] == 101);
+	Ring.Release(1);
+	SIA_CHECK(Ring.PopBatch(Items, 8) == 5);
+	for (int i = 0; i < 5; i++) {
+		SIA_CHECK(Items[i] == 101 + i);
+	}
+	Ring.Push(1);
+	Ring.Clear();
+	SIA_CHECK(Ring.Empty() && Ring.Peek().Empty());
+}
+
+// 生产者、消费者在不同线程中，读到的序列完整且有序
+static void TestSpscThreads() {
+	static sia::SpscRing<uint32_t, 64> Ring;
+	const uint32_t COUNT = 200000;
+	std::thread Producer([]() {
+		for (uint32_t i = 0; i < COUNT; i++) {
+			while (!Ring.Push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	uint32_t Expected = 0;
+	uint32_t Items[16];
+	bool Ordered = true;
+	while (Expected < COUNT) {
+		const size_t Count = Ring.PopBatch(Items, 16);
+		if (Count == 0) {
+			std::this_thread::yield();
+		}
+		for (size_t i = 0; i < Count; i++) {
+			Ordered = Ordered && Items[i] == Expected;
+			Expected++;
+		}
+	}
+	Producer.join();
+	SIA_CHECK(Ordered && Ring.Empty());
+}
+
+// 多字的元素，读到的Value与Check不一致即为读写重叠
+struct TestItem {
+	uint64_t Value;
+	uint64_t Check;
+	uint64_t Padding[2];
+};
+static TestItem MakeItem(uint64_t value) {
+	return { value, ~value, { value, value } };
+}
+
+// 按顺序读取；被超过一圈时跳到仍有效的最旧元素，累计丢失的元素数及被超过的次数
+static void TestBroadcastLapped() {
+	static sia::BroadcastRing<TestItem, 16> Ring;
+	TestItem Item;
+	SIA_CHECK(!Ring.ReadLatest(&Item));
+	sia::BroadcastReader<TestItem, 16> Reader(Ring);
+	SIA_CHECK(!Reader.Next(&Item));
+	for (uint64_t i = 0; i < 10; i++) {
+		Ring.Publish(MakeItem(i));
+	}
+	for (uint64_t i = 0; i < 10; i++) {
+		SIA_CHECK(Reader.Next(&Item) && Item.Value == i);
+	}
+	SIA_CHECK(!Reader.Next(&Item) && Reader.LapCount() == 0);
+	for (uint64_t i = 10; i < 50; i++) { // 超过读取位置一圈以上
+		Ring.Publish(MakeItem(i));
+	}
+	SIA_CHECK(Reader.Pending() == 40);
+	// 容量16，留出N/8=2的余量，跳到50-14=36
+	SIA_CHECK(Reader.Next(&Item) && Item.Value == 36);
+	SIA_CHECK(Reader.LapCount() == 1 && Reader.LostCount() == 26);
+	uint64_t Expected = 37;
+	while (Reader.Next(&Item)) {
+		SIA_CHECK(Item.Value == Expected++);
+	}
+	SIA_CHECK(Expected == 50 && Ring.Head() == 50);
+	SIA_CHECK(Ring.ReadLatest(&Item) && Item.Value == 49);
+}
+
+// 抽取及只读最新的元素
+static void TestBroadcastDecimation() {
+	static sia::BroadcastRing<TestItem, 16> Ring;
+	sia::BroadcastReader<TestItem, 16> Reader(Ring, 3);
+	TestItem Item;
+	for (uint64_t i = 0; i < 12; i++) {
+		Ring.Publish(MakeItem(i));
+	}
+	for (uint64_t i = 0; i < 12; i += 3) {
+		SIA_CHECK(Reader.Next(&Item) && Item.Value == i);
+	}
+	SIA_CHECK(!Reader.Next(&Item));
+	Ring.Publish(MakeItem(12));
+	Ring.Publish(MakeItem(13));
+	SIA_CHECK(Reader.Latest(&Item) && Item.Value == 13);
+	SIA_CHECK(!Reader.Latest(&Item) && Reader.LostCount() == 0);
+}
+
+// 生产者不等待消费者：读到的元素完整、递增，读到的个数加上丢失的个数等于写入的个数
+static void TestBroadcastThreads() {
+	static sia::BroadcastRing<TestItem, 64> Ring;
+	const uint64_t COUNT = 200000;
+	sia::BroadcastReader<TestItem, 64> Reader(Ring);
+	std::thread Producer([]() {
+		for (uint64_t i = 0; i < COUNT; i++) {
+			Ring.Publish(MakeItem(i));
+		}
+	});
+	uint64_t ReadCount = 0;
+	uint64_t Last = 0;
+	bool Valid = true;
+	TestItem Item;
+	while (ReadCount + Reader.LostCount() < COUNT) {
+		if (!Reader.Next(&Item)) {
+			std::this_thread::yield();
+			continue;
+		}
+		Valid = Valid && Item.Check == ~Item.Value && Item.Padding[1] == Item.Value && (ReadCount == 0 || Item.Value > Last);
+		Last = Item.Value;
+		ReadCount++;
+	}
+	Producer.join();
+	SIA_CHECK(Valid && Last == COUNT - 1 && ReadCount + Reader.LostCount() == COUNT);
+}
+
+int main() {
+	TestSpscWrapAround();
+	TestSpscBatch();
+	TestSpscThreads();
+	TestBroadcastLapped();
+	TestBroadcastDecimation();
+	TestBroadcastThreads();
+	return TestResult("RingBufferTest");
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// 测试用的检查宏：条件不成立时输出位置并计数，测试程序在有失败时返回非0
+static int TestFailureCount = 0;
+
+#define SIA_CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			TestFailureCount++; \
+		} \
+	} while (0)
+
+// |a - b| <= tolerance
+#define SIA_CHECK_NEAR(a, b, tolerance) SIA_CHECK(std::fabs((double)(a) - (double)(b)) <= (double)(tolerance))
+
+// 输出结果并作为main的返回值
+inline int TestResult(const char* name) {
+	if (TestFailureCount == 0) {
+		printf("%s: passed\n", name);
+		return 0;
+	}
+	printf("%s: %d check(s) failed\n", name, TestFailureCount);
+	return 1;
+}
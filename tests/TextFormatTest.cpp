@@ -0,0 +1,120 @@
+// TextFormat的整数、定点及最短格式测试：与printf的结果对照，最短格式能解析回原值且位数最少
+#include <cfloat>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include "TextFormat.hpp"
+#include "TestCheck.hpp"
+
+static std::string Fixed(float value, int precision) {
+	char Text[sia::TEXT_NUMBER_MAX_SIZE];
+	return std::string(Text, sia::FormatFixed(Text, value, precision));
+}
+static std::string Shortest(float value) {
+	char Text[sia::TEXT_NUMBER_MAX_SIZE];
+	return std::string(Text, sia::FormatShortest(Text, value));
+}
+static std::string Printf(const char* format, int precision, double value) {
+	char Text[512];
+	snprintf(Text, sizeof(Text), format, precision, value);
+	return Text;
+}
+
+// 有效数字的位数：去掉符号、指数、小数点及首尾的0
+static int SignificantDigits(const std::string& text) {
+	std::string Digits;
+	for (char c : text) {
+		if (c == 'e') {
+			break;
+		}
+		if (c >= '0' && c <= '9') {
+			Digits += c;
+		}
+	}
+	const size_t First = Digits.find_first_not_of('0');
+	if (First == std::string::npos) {
+		return 0;
+	}
+	return (int)(Digits.find_last_not_of('0') - First + 1);
+}
+
+// 能解析回value的最少有效数字位数
+static int MinimalDigits(float value) {
+	for (int Precision = 1; Precision < 9; Precision++) {
+		if (strtof(Printf("%.*g", Precision, value).c_str(), nullptr) == value) {
+			return Precision;
+		}
+	}
+	return 9;
+}
+
+static void TestInt() {
+	char Text[sia::TEXT_NUMBER_MAX_SIZE];
+	SIA_CHECK(std::string(Text, sia::FormatUInt(Text, 0)) == "0");
+	SIA_CHECK(std::string(Text, sia::FormatUInt(Text, UINT64_MAX)) == "18446744073709551615");
+	SIA_CHECK(std::string(Text, sia::FormatInt(Text, -1653)) == "-1653");
+	SIA_CHECK(std::string(Text, sia::FormatInt(Text, INT64_MIN)) == "-9223372036854775808");
+	SIA_CHECK(std::string(Text, sia::FormatInt(Text, INT64_MAX)) == "9223372036854775807");
+}
+
+static void TestNonFinite() {
+	SIA_CHECK(Shortest(NAN) == "nan" && Fixed(-NAN, 3) == "-nan");
+	SIA_CHECK(Shortest(INFINITY) == "inf" && Fixed(-INFINITY, 3) == "-inf");
+}
+
+static void TestFixed() {
+	SIA_CHECK(Fixed(0.0f, 3) == "0.000" && Fixed(-0.0f, 0) == "-0");
+	SIA_CHECK(Fixed(-32.8f, 3) == "-32.800");
+	SIA_CHECK(Fixed(2.5f, 0) == "2" && Fixed(3.5f, 0) == "4"); // 就近偶数
+	SIA_CHECK(Fixed(0.125f, 2) == "0.12" && Fixed(0.375f, 2) == "0.38");
+	SIA_CHECK(Fixed(0.1f, 12) == "0.100000001490");
+	SIA_CHECK(Fixed(FLT_MAX, 1) == "340282346638528859811704183484516925440.0");
+	// 各精度下与printf一致，包括超出快速路径的精度及很大、很小的数
+	std::mt19937 Random(1653);
+	std::uniform_int_distribution<uint32_t> Bits(0, 0x7F7FFFFF);
+	for (int i = 0; i < 20000; i++) {
+		uint32_t Raw = Bits(Random) | ((i & 1) ? 0x80000000u : 0u);
+		float Value;
+		memcpy(&Value, &Raw, sizeof(Value));
+		const int Precision = i % 21;
+		SIA_CHECK(Fixed(Value, Precision) == Printf("%.*f", Precision, Value));
+	}
+}
+
+static void TestShortest() {
+	SIA_CHECK(Shortest(0.0f) == "0" && Shortest(-0.0f) == "-0");
+	SIA_CHECK(Shortest(0.1f) == "0.1" && Shortest(1653.801f) == "1653.801" && Shortest(-32.8f) == "-32.8");
+	SIA_CHECK(Shortest(100.0f) == "100" && Shortest(0.001f) == "0.001");
+	SIA_CHECK(Shortest(1e-5f) == "1e-05" && Shortest(1.5e-5f) == "1.5e-05");
+	SIA_CHECK(Shortest(1e10f) == "1e+10" && Shortest(FLT_MAX) == "3.4028235e+38");
+	SIA_CHECK(Shortest(FLT_MIN) == "1.1754944e-38" && Shortest(std::numeric_limits<float>::denorm_min()) == "1e-45");
+	// 随机的单精度数（包括非规格化数）能解析回原值，且位数最少
+	std::mt19937 Random(801);
+	std::uniform_int_distribution<uint32_t> Bits(1, 0x7F7FFFFF);
+	for (int i = 0; i < 100000; i++) {
+		uint32_t Raw = Bits(Random);
+		if (i % 4 == 0) {
+			Raw = (Raw & 0x007FFFFF) | 1; // 非规格化数
+		}
+		float Value;
+		memcpy(&Value, &Raw, sizeof(Value));
+		const std::string Text = Shortest(Value);
+		// 定点格式下不需要小数位的数即为其精确的整数值，其余的有效数字位数最少
+		const bool IsInteger = (Text.find_first_of(".e") == std::string::npos);
+		const bool IsShortest = IsInteger ? (Text == Printf("%.*f", 0, Value)) : (SignificantDigits(Text) == MinimalDigits(Value));
+		if (strtof(Text.c_str(), nullptr) != Value || !IsShortest) {
+			fprintf(stderr, "%.9g -> %s\n", Value, Text.c_str());
+			TestFailureCount++;
+		}
+	}
+}
+
+int main() {
+	TestInt();
+	TestNonFinite();
+	TestFixed();
+	TestShortest();
+	return TestResult("TextFormatTest");
+}
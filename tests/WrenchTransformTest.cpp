@@ -0,0 +1,121 @@
+// WrenchTransform的标定矩阵及工具坐标系变换测试
+#include <cmath>
+#include "WrenchTransform.hpp"
+#include "TestCheck.hpp"
+
+static const double TOLERANCE = 1e-4;
+
+static bool Near(const sia::ForceSensorData& actual, const double* expected) {
+	for (int i = 0; i < sia::DATA_COUNT; i++) {
+		if (std::fabs(actual[i] - expected[i]) > TOLERANCE * (1.0 + std::fabs(expected[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+static void Cross(const double* a, const double* b, double* out) {
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+// R^T * v
+static void RotateBack(const sia::RotationMatrix& r, const double* v, double* out) {
+	for (int i = 0; i < 3; i++) {
+		out[i] = r[i] * v[0] + r[3 + i] * v[1] + r[6 + i] * v[2];
+	}
+}
+// 绕单位轴axis旋转angle的旋转矩阵（Rodrigues公式）
+static sia::RotationMatrix AxisAngle(double x, double y, double z, double angle) {
+	const double Norm = std::sqrt(x * x + y * y + z * z);
+	x /= Norm;
+	y /= Norm;
+	z /= Norm;
+	const double C = std::cos(angle);
+	const double S = std::sin(angle);
+	const double T = 1.0 - C;
+	return { T * x * x + C, T * x * y - S * z, T * x * z + S * y,
+		T * x * y + S * z, T * y * y + C, T * y * z - S * x,
+		T * x * z - S * y, T * y * z + S * x, T * z * z + C };
+}
+
+static void TestIdentity() {
+	sia::WrenchTransform Transform;
+	const sia::ForceSensorData In = { 1.0f, -2.0f, 3.0f, -0.4f, 0.5f, -0.6f };
+	sia::ForceSensorData Out;
+	Transform.Transform(In, &Out);
+	SIA_CHECK(Out == In);
+}
+
+// 在工具中心点施加的纯力：工具坐标系中力矩为0，力为R^T * F
+static void TestPointForceAtTool() {
+	sia::WrenchTransform Transform;
+	const sia::RotationMatrix R = AxisAngle(1.0, 2.0, 3.0, 0.7);
+	const sia::Vector3 P = { 0.1, -0.2, 0.3 };
+	Transform.SetToolFrame(R, P);
+	const double Force[3] = { 5.0, -3.0, 12.0 };
+	double Torque[3];
+	Cross(P.data(), Force, Torque); // 传感器测得的力矩 p x F
+	const sia::ForceSensorData In = { (float)Force[0], (float)Force[1], (float)Force[2], (float)Torque[0], (float)Torque[1], (float)Torque[2] };
+	double Expected[6] = {};
+	RotateBack(R, Force, Expected);
+	sia::ForceSensorData Out;
+	Transform.Transform(In, &Out);
+	SIA_CHECK(Near(Out, Expected));
+}
+
+// 纯力矩与工具中心点的位置无关，只随姿态旋转
+static void TestPureTorque() {
+	sia::WrenchTransform Transform;
+	const sia::RotationMatrix R = AxisAngle(0.0, 0.0, 1.0, 3.14159265358979323846 / 2.0);
+	Transform.SetToolFrame(R, { 1.0, 2.0, 3.0 });
+	const sia::ForceSensorData In = { 0.0f, 0.0f, 0.0f, 1.0f, 2.0f, 3.0f };
+	const double Expected[6] = { 0.0, 0.0, 0.0, 2.0, -1.0, 3.0 }; // 工具x轴为传感器y轴
+	sia::ForceSensorData Out;
+	Transform.Transform(In, &Out);
+	SIA_CHECK(Near(Out, Expected));
+}
+
+// 先标定后变换：结果与按定义逐步计算的一致，修改配置后下一个数据生效
+static void TestCalibrationThenToolFrame() {
+	sia::WrenchMatrix C;
+	for (int i = 0; i < sia::DATA_COUNT; i++) {
+		for (int j = 0; j < sia::DATA_COUNT; j++) {
+			C[i * sia::DATA_COUNT + j] = (i == j) ? 1.0 + 0.1 * i : 0.01 * (i - j);
+		}
+	}
+	const sia::RotationMatrix R = AxisAngle(-1.0, 0.5, 2.0, 1.3);
+	const sia::Vector3 P = { 0.05, 0.0, -0.12 };
+	const sia::ForceSensorData In = { 10.0f, -20.0f, 30.0f, 1.0f, -2.0f, 3.0f };
+
+	double W[6] = {}; // w_s = C * w
+	for (int i = 0; i < sia::DATA_COUNT; i++) {
+		for (int j = 0; j < sia::DATA_COUNT; j++) {
+			W[i] += C[i * sia::DATA_COUNT + j] * In[j];
+		}
+	}
+	double Expected[6];
+	double PxF[3];
+	Cross(P.data(), W, PxF);
+	const double TorqueAtTool[3] = { W[3] - PxF[0], W[4] - PxF[1], W[5] - PxF[2] };
+	RotateBack(R, W, Expected);
+	RotateBack(R, TorqueAtTool, Expected + 3);
+
+	sia::WrenchTransform Transform;
+	sia::ForceSensorData Out = In;
+	SIA_CHECK(Transform.Process(Out) && Out == In);
+	Transform.SetCalibration(C);
+	Transform.SetToolFrame(R, P);
+	Out = In;
+	SIA_CHECK(Transform.Process(Out) && Near(Out, Expected));
+	Transform.Reset();
+	Out = In;
+	SIA_CHECK(Transform.Process(Out) && Out == In);
+}
+
+int main() {
+	TestIdentity();
+	TestPointForceAtTool();
+	TestPureTorque();
+	TestCalibrationThenToolFrame();
+	return TestResult("WrenchTransformTest");
+}